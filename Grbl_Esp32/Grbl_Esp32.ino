@@ -30,7 +30,7 @@ void setup()
 
 #ifdef ENABLE_BLUETOOTH
     char line[LINE_BUFFER_SIZE] = "Waterino";
-    Serial.printf("Starting Bluetooth");
+    grbl_send(CLIENT_SERIAL, "Starting Bluetooth");
     bluetooth_init(line);
 #endif
 
@@ -64,6 +64,8 @@ void loop()
     uint8_t prior_state = sys.state;
     memset(&sys, 0, sizeof(system_t)); // Clear system struct variable.
     sys.state = prior_state;
+    sys.f_override = DEFAULT_FEED_OVERRIDE;  // Set to 100%
+    sys.r_override = DEFAULT_RAPID_OVERRIDE; // Set to 100%
     sys_rt_exec_state = 0;
     sys_rt_exec_alarm = 0;
     sys_rt_exec_motion_override = 0;
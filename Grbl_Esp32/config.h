@@ -49,6 +49,15 @@
 // #define CMD_CYCLE_START 0x82
 // #define CMD_FEED_HOLD 0x83
 #define CMD_JOG_CANCEL  0x85
+#define CMD_FEED_OVR_RESET 0x90         // Restores feed override value to 100%.
+#define CMD_FEED_OVR_COARSE_PLUS 0x91
+#define CMD_FEED_OVR_COARSE_MINUS 0x92
+#define CMD_FEED_OVR_FINE_PLUS  0x93
+#define CMD_FEED_OVR_FINE_MINUS  0x94
+#define CMD_RAPID_OVR_RESET 0x95        // Restores rapid override value to 100%.
+#define CMD_RAPID_OVR_MEDIUM 0x96
+#define CMD_RAPID_OVR_LOW 0x97
+// #define CMD_RAPID_OVR_EXTRA_LOW 0x98 // *NOT SUPPORTED*
 
 
 // If homing is enabled, homing init lock sets Grbl into an alarm state upon power up. This forces
@@ -96,6 +105,20 @@
 // parser state depending on user preferences.
 #define N_STARTUP_LINE 10 // Integer (1-2)
 
+// Records the step segments of the startup blocks, run by '$F6', into a flash partition on the first
+// run, and replays them on later runs. The blocks are then only parsed, for the parser state, while
+// planning and segment generation are skipped. A recording is used only for the same startup blocks,
+// settings, parser state, machine position and firmware build, so any change records it anew. Startup
+// blocks that wait for motion to complete, like dwells, program pauses or M-codes, are not recorded.
+// NOTE: A feed hold during a replay hands the rest of the recording to the planner, so the machine
+// decelerates as usual and a cycle start completes the startup blocks. Any blocks beyond the planner
+// buffer size are dropped then, and the parser position follows the machine.
+// NOTE: Needs a data partition of its own, which is erased and overwritten at will. The default
+// partition table has none. doc/partitions_startup_cache.csv adds one. Without it, nothing is recorded.
+// #define STARTUP_CACHE // Default disabled. Uncomment to enable.
+#define STARTUP_CACHE_PARTITION "startup_cache" // Label of the data partition holding the recording.
+#define STARTUP_CACHE_SIZE 32768 // Largest recording in bytes. Allocated while recording or replaying.
+
 // Number of floating decimal points printed by Grbl for certain value types. These settings are
 // determined by realistic and commonly observed values in CNC machines. For example, position
 // values cannot be less than 0.001mm or 0.0001in, because machines can not be physically more
@@ -164,6 +187,72 @@
 // step smoothing. See stepper.c for more details on the AMASS system works.
 #define ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING  // Default enabled. Comment to disable.
 
+// Adapts the step segment duration to the velocity profile. Segments on acceleration and deceleration
+// ramps last 1/SEGMENT_RAMP_TICKS_PER_SECOND, to trace the speed changes more finely. Cruise segments
+// last 1/SEGMENT_CRUISE_TICKS_PER_SECOND, so long constant-speed moves need fewer segments to compute
+// and buffer. ACCELERATION_TICKS_PER_SECOND then only sets the increment used to stretch very slow
+// segments up to one step. $P reports the segments generated per planner block.
+// NOTE: Cruise segments queued in the segment buffer run before a feed hold can start decelerating, so
+// longer cruise segments delay the hold by up to (SEGMENT_BUFFER_SIZE-1) of them.
+#define ADAPTIVE_SEGMENT_DURATION // Default enabled. Comment to disable.
+#define SEGMENT_RAMP_TICKS_PER_SECOND 200 // Segments per second on ramps.
+#define SEGMENT_CRUISE_TICKS_PER_SECOND 40 // Segments per second while cruising.
+
+// Jerk-limited (S-curve) acceleration. The acceleration rises and falls at no more than the axis jerk
+// limits ($140-$141, mm/sec^3) instead of stepping instantly to the $120-$121 value, and never exceeds
+// the latter. The planner and the segment generator size every ramp for this, so ramps take longer
+// and short moves are planned slower. Each block starts and ends at zero acceleration, which slows
+// streams of very short segments the most. A replan in the middle of a ramp takes effect once its
+// acceleration is back to zero. A jerk limit of 0 leaves that axis on plain trapezoid ramps.
+// #define JERK_LIMITED_ACCELERATION // Default disabled. Uncomment to enable.
+
+// Counts the steps of the executing segment in small per-axis accumulators inside the stepper ISR
+// and adds them to the machine position (sys_position) only when the segment completes or the
+// steppers stop, rather than updating the int32 position counters on every step. Realtime position
+// readers, like status reports and homing, use st_get_realtime_position(), which adds the steps of
+// the segment in progress, so the reported position is still exact to the step.
+#define SEGMENT_POSITION_ACCOUNTING // Default enabled. Comment to disable.
+
+// Instruments the stepper driver interrupt with the CPU cycle counter. Records the minimum, average
+// and maximum ISR execution time, a log2 histogram of execution times, the number of ISR entries
+// rejected by the busy flag and the number of ticks where the next timer alarm had already passed
+// when the ISR finished. Also times the planner recalculation for each new block. Printed with '$P'
+// and cleared with '$PR'. Costs a few dozen CPU cycles per tick.
+// #define STEPPER_ISR_PROFILER // Default disabled. Uncomment to enable.
+
+// Adds the segment buffer underrun state to the status report as '|Un:' followed by the number of stops
+// on a starved segment buffer and the fewest segments queued during the current or last cycle. A
+// starvation stop is an end of motion with segments still to come, caused by the segment generator
+// falling behind, and is otherwise indistinguishable from a normal stop. '$P' reports the full counts,
+// with STEPPER_ISR_PROFILER.
+// #define REPORT_FIELD_SEGMENT_UNDERRUN // Default disabled. Uncomment to enable.
+
+// Adds the feed and rapid override values in percent to the status report as '|Ov:feed,rapid'. To
+// save bandwidth, the field is only sent when an override changes or once every so many reports,
+// refreshing faster while the machine is busy than when it is idle.
+#define REPORT_FIELD_OVERRIDES // Default enabled. Comment to disable.
+
+// Adds the free planner blocks and the free bytes in the receive buffer of the requesting client to
+// the status report as '|Bf:blocks,bytes', when bit 1 of the status report mask ($10) is set. Both
+// values are 16 bit. A sender can read the buffer sizes once from an idle report.
+#define REPORT_FIELD_BUFFER_STATE // Default enabled. Comment to disable.
+#define REPORT_OVR_REFRESH_BUSY_COUNT 20  // (1-255)
+#define REPORT_OVR_REFRESH_IDLE_COUNT 10  // (1-255) Must be less than or equal to the busy count
+
+// Records the CPU cycle counter, step bits and direction bits of every step pulse in a ring buffer
+// inside the stepper ISR, for offline analysis of the jitter between step edges. The buffer keeps the
+// last STEP_TRACE_SIZE step pulses (8 bytes each). Printed with '$T' and cleared with '$TR'. The host
+// simulation writes it to a file with its '-j' option.
+// #define STEP_TRACE // Default disabled. Uncomment to enable.
+#define STEP_TRACE_SIZE 512 // Step pulses. Must be a power of 2.
+
+// Adds '$CE', a check mode that also estimates the run time of the checked program. The motions are
+// planned as usual and the segment generator computes their acceleration ramps and step timing, but
+// the segments are discarded instead of stepped and only their step timer ticks are added up. Dwells
+// add their time. Leaving the mode with '$CE' or '$C' prints the estimated time, the peak path rate
+// and the peak rate of each axis before the usual reset.
+#define CHECK_MODE_ESTIMATE // Default enabled. Comment to disable.
+
 // Sets the maximum step rate allowed to be written as a Grbl setting. This option enables an error
 // check in the settings module to prevent settings values that will exceed this limitation. The maximum
 // step rate is strictly limited by the CPU speed and will change if something other than an AVR running
@@ -171,6 +260,24 @@
 // NOTE: For now disabled, will enable if flash space permits.
 // #define MAX_STEP_RATE_HZ 30000 // Hz
 
+// Measures the stepper ISR at boot and limits the step rate to what the CPU can sustain. The ISR
+// is run on a synthetic block with every axis stepping, at every segment and block boundary the
+// segment buffer allows, with the step pins masked. The average cost per tick, the pulse reset
+// interrupt and STEP_RATE_GOVERNOR_ISR_ENTRY_CYCLES per interrupt set the maximum step rate, so
+// that the step interrupts take no more than STEP_RATE_GOVERNOR_LOAD_PERCENT of the core. Planned feed and rapid rates are
+// clamped to it and axis settings that would exceed it are rejected. Also capped by MAX_STEP_RATE_HZ,
+// when defined. The measured rate is reported by '$I'.
+#define STEP_RATE_GOVERNOR // Default enabled. Comment to disable.
+#define STEP_RATE_GOVERNOR_LOAD_PERCENT 50 // Percent of the CPU core the stepper ISR may use.
+#define STEP_RATE_GOVERNOR_TICKS 1000 // ISR ticks run by the benchmark.
+#define STEP_RATE_GOVERNOR_CHUNK_TICKS 200 // Most ISR ticks run with interrupts masked at a time.
+// The benchmark calls the ISR directly, so it does not see what taking the interrupt costs: the
+// level 1 interrupt vector saving and restoring the CPU context, and the dispatcher of the shared
+// handler that timer_isr_register() installs calling the ISR. This adds that cost per interrupt,
+// for entry and exit together. 480 cycles is not measured. It is a deliberately high estimate, which
+// errs towards a lower maximum step rate. Raise it when steps are still lost below the '$I' rate.
+#define STEP_RATE_GOVERNOR_ISR_ENTRY_CYCLES 480 // CPU cycles. 2us at 240MHz.
+
 // By default, Grbl sets all input pins to normal-high operation with their internal pull-up resistors
 // enabled. This simplifies the wiring for users by requiring only a switch connected to ground,
 // although its recommended that users take the extra step of wiring in low-pass filter to reduce
@@ -209,24 +316,35 @@
 // time step. Also, keep in mind that the Arduino delay timer is not very accurate for long delays.
 #define DWELL_TIME_STEP 50 // Integer (1-255) (milliseconds)
 
-// Creates a delay between the direction pin setting and corresponding step pulse by creating
-// another interrupt (Timer2 compare) to manage it. The main Grbl interrupt (Timer1 compare)
-// sets the direction pins, and does not immediately set the stepper pins, as it would in
-// normal operation. The Timer2 compare fires next to set the stepper pins after the step
-// pulse delay time, and Timer2 overflow will complete the step pulse, except now delayed
-// by the step pulse time plus the step pulse delay. (Thanks langwadt for the idea!)
-// NOTE: Uncomment to enable. The recommended delay must be > 3us, and, when added with the
-// user-supplied step pulse time, the total time must not exceed 127us. Reported successful
-// values for certain setups have ranged from 5 to 20us.
-// !!!!! ESP32 Not currently implemented
+// Generates the step pulses with the ESP32 RMT peripheral instead of setting the step pins from the
+// stepper ISR and clearing them from the step pulse reset timer. Each axis step pin gets its own RMT
+// channel, loaded with the $0 pulse shape, and the stepper ISR only starts the channels that step.
+// Pulse widths are exact and the ISR execution time no longer depends on the pulse length.
+// NOTE: Uses RMT channels 0 and 1. Direction pins are still set directly by the stepper ISR.
+// #define USE_RMT_STEPS // Default disabled. Uncomment to enable.
+
+// Creates a delay between the direction pin setting and corresponding step pulse. The stepper ISR
+// sets the direction pins, and the RMT holds the step pin at its idle level for the delay before
+// the step pulse starts, so the whole pulse ends after the step pulse delay plus the step pulse time.
+// NOTE: Uncomment to enable. Requires USE_RMT_STEPS. The recommended delay must be > 3us. Reported
+// successful values for certain setups have ranged from 5 to 20us.
 // #define STEP_PULSE_DELAY 10 // Step pulse delay in microseconds. Default disabled.
 
 // The number of linear motions in the planner buffer to be planned at any give time. The vast
-// majority of RAM that Grbl uses is based on this buffer size. Only increase if there is extra
-// available RAM, like when re-compiling for a Mega2560. Or decrease if the Arduino begins to
-// crash due to the lack of available RAM or if the CPU is having trouble keeping up with planning
-// new incoming motions as they are executed.
-// #define BLOCK_BUFFER_SIZE 16 // Uncomment to override default in planner.h.
+// majority of RAM that Grbl uses is based on this buffer size, about 80 bytes per block. A longer
+// buffer lets the planner reach higher speeds on programs of many short lines, since it always plans
+// to stop at the end of the buffer. The recalculation cost per new block depends on the blocks not
+// yet optimally planned, not on the buffer size, see planner_recalculate(). Up to 65535 blocks.
+// NOTE: '$P' prints the planner recalculation times, with STEPPER_ISR_PROFILER enabled. 'make bench' in
+// sim/ checks that the recalculations per new block do not grow with the buffer size.
+// #define BLOCK_BUFFER_SIZE 128 // Uncomment to override default in planner.h.
+
+// Allocates the planner buffer in the external PSRAM of boards like the WROVER, leaving the internal
+// RAM to the rest of the firmware. Falls back to internal RAM on boards without PSRAM, and to a buffer of
+// BLOCK_BUFFER_FALLBACK_SIZE blocks when that has no room either. '$I' reports the blocks. Only the
+// main program and the segment generator read planner blocks, never the stepper ISR, so the slower
+// PSRAM does not affect step timing.
+// #define PLANNER_BUFFER_IN_PSRAM // Default disabled. Uncomment to enable.
 
 // Governs the size of the intermediary step segment buffer between the step execution algorithm
 // and the planner blocks. Each segment is set of steps executed at a constant velocity over a
@@ -234,8 +352,22 @@
 // block velocity profile is traced exactly. The size of this buffer governs how much step
 // execution lead time there is for other Grbl processes have to compute and do their thing
 // before having to come back and refill this buffer, currently at ~50msec of step moves.
+// NOTE: The ring is lock-free and may be raised to 32 or more segments (up to 255) to ride out longer
+// main loop stalls, at 6 bytes of RAM per segment plus 16 per stepper block. $P reports how deep the
+// buffer has actually filled.
 // #define SEGMENT_BUFFER_SIZE 6 // Uncomment to override default in stepper.h.
 
+// Refills the step segment buffer from a dedicated FreeRTOS task, rather than only when the main
+// loop happens to run the realtime protocol. The stepper ISR notifies the task whenever a completed
+// segment leaves fewer than SEGMENT_BUFFER_LOW_WATER segments queued, so a long g-code line, a slow
+// serial send or an EEPROM commit can no longer starve the steppers. The task runs on the same core
+// as the stepper ISR, at a higher priority than the main loop. The planner and segment generator
+// are serialized with a mutex. The main loop still primes the buffer at cycle start.
+#define USE_SEGMENT_PREP_TASK // Default enabled. Comment to disable.
+#define SEGMENT_PREP_TASK_PRIORITY 3 // Above the Arduino main loop (1).
+#define SEGMENT_PREP_TASK_CORE 1 // Core of the main loop, where the stepper ISR is installed.
+#define SEGMENT_BUFFER_LOW_WATER 3 // Queued segments. Must be less than SEGMENT_BUFFER_SIZE.
+
 // Line buffer size from the serial input stream to be executed. Also, governs the size of
 // each of the startup blocks, as they are each stored as a string of this size. Make sure
 // to account for the available EEPROM at the defined memory address in settings.h and for
@@ -246,6 +378,12 @@
 // we know how much extra memory space we can re-invest into this.
 // #define LINE_BUFFER_SIZE 80  // Uncomment to override default in protocol.h
 
+// Each client (USB serial, Bluetooth, WebUI) has its own line buffer. The main loop serves the
+// clients in turn and executes at most this many lines of one client before moving on, so a phone
+// over Bluetooth stays responsive while a PC streams over USB. A lower budget switches more often
+// and a higher one lets a streaming client parse ahead in larger bursts.
+// #define CLIENT_LINE_BUDGET 4 // (1-255) Uncomment to override default in protocol.h
+
 // Serial send and receive buffer size. The receive buffer is often used as another streaming
 // buffer to store incoming blocks to be processed by Grbl when its ready. Most streaming
 // interfaces will character count and track each block send to each block response. So,
@@ -256,8 +394,30 @@
 // 115200 baud will take 5 msec to transmit a typical 55 character report. Worst case reports are
 // around 90-100 characters. As long as the serial TX buffer doesn't get continually maxed, Grbl
 // will continue operating efficiently. Size the TX buffer around the size of a worst-case report.
-// #define RX_BUFFER_SIZE 128 // (1-254) Uncomment to override defaults in serial.h
-// #define TX_BUFFER_SIZE 100 // (1-254)
+// NOTE: The receive buffer is 1024 bytes per client by default, so a character counting sender can
+// keep several lines in flight to hide the round-trip time of the link, which is long over Bluetooth.
+// The free space is reported in the Bf: status field and the size in the [OPT:] build info line.
+// #define RX_BUFFER_SIZE 1024 // (1-65534) Uncomment to override defaults in serial.h
+// #define TX_BUFFER_SIZE 1024 // (1-65534)
+
+// Reads the USB serial port (UART0) with the ESP-IDF UART driver instead of the Arduino Serial object.
+// A dedicated task sleeps on the driver's event queue and, when woken, reads all received bytes in
+// chunks. Each chunk is scanned for realtime command characters, and the runs of other characters
+// between them are copied into the receive buffer in one pass. Grbl's output is written through the
+// same driver. NOTE: The Arduino Serial object is not started then and its print functions do nothing.
+#define USE_UART_EVENT_QUEUE // Default enabled. Comment to disable.
+#define UART_DRIVER_RX_BUFFER_SIZE 1024 // Bytes. Receive buffer of the UART driver. Must be over 128.
+#define UART_EVENT_QUEUE_SIZE 16 // UART driver events
+#define UART_READ_CHUNK_SIZE 128 // Bytes read from the UART driver at a time. On the reader task stack.
+
+// Queues Grbl's output per client in a send buffer of TX_BUFFER_SIZE bytes, which a dedicated task
+// writes to the USB serial port and to Bluetooth. grbl_send() returns once the message is queued, so
+// the main loop only waits for output when a send buffer is full. Messages queued while a write is in
+// progress are written together, in fewer and larger writes. When a client's output does not drain
+// for SERIAL_TX_STALL_TIMEOUT, like a Bluetooth peer that stopped reading, the output that does not
+// fit its send buffer is dropped, so the main loop and realtime replies are never held up by it.
+#define SERIAL_TX_TASK // Default enabled. Comment to disable.
+#define SERIAL_TX_STALL_TIMEOUT 500 // Milliseconds. Longest wait for room in a full send buffer. Then output is dropped.
 
 // A simple software debouncing feature for hard limit switches. When enabled, the interrupt
 // monitoring the hard limit switch pins will enable the Arduino's watchdog timer to re-check
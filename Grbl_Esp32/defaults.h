@@ -54,6 +54,12 @@
 #define DEFAULT_X_MAX_TRAVEL 359.0 // mm NOTE: Must be a positive value.
 #define DEFAULT_Y_MAX_TRAVEL 90.0 // mm NOTE: Must be a positive value.
 
+#define DEFAULT_X_JERK (0.0*60*60*60) // mm/min^3. 0 = unlimited, plain trapezoid ramps.
+#define DEFAULT_Y_JERK (0.0*60*60*60) // mm/min^3. 0 = unlimited, plain trapezoid ramps.
+
+#define DEFAULT_X_ROTARY_TRAVEL 0.0 // mm per turn. 0 = linear axis. 360.0 for the 360 degree pan axis.
+#define DEFAULT_Y_ROTARY_TRAVEL 0.0 // mm per turn. 0 = linear axis.
+
 
 #endif
 
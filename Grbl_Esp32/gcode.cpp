@@ -640,6 +640,10 @@ uint8_t gc_execute_line(char *line, uint8_t client)
     plan_line_data_t plan_data;
     plan_line_data_t *pl_data = &plan_data;
     memset(pl_data, 0, sizeof(plan_line_data_t)); // Zero pl_data struct
+    if (gc_block.modal.distance == DISTANCE_MODE_ABSOLUTE)
+    {
+        pl_data->condition |= PL_COND_FLAG_ROTARY_SHORTEST; // Incremental moves keep their rotary distance.
+    }
 
     // Intercept jog commands and complete error checking for valid jog commands and execute.
     // NOTE: G-code parser state is not updated, except the position to ensure sequential jog
@@ -781,6 +785,10 @@ uint8_t gc_execute_line(char *line, uint8_t client)
             gc_state.modal.distance = DISTANCE_MODE_ABSOLUTE;
             gc_state.modal.feed_rate = FEED_RATE_MODE_UNITS_PER_MIN;
 
+#ifdef RESTORE_OVERRIDES_AFTER_PROGRAM_END
+            sys.f_override = DEFAULT_FEED_OVERRIDE;
+            sys.r_override = DEFAULT_RAPID_OVERRIDE;
+#endif
 
             // Execute coordinate change
             if (sys.state != STATE_CHECK_MODE)
@@ -5,6 +5,11 @@
 
 */
 
+// Guarded, since config.h includes this file again for the Arduino IDE. Without the guard, that
+// nested include pulls in the module headers before the config.h options are defined.
+#ifndef grbl_h
+#define grbl_h
+
 // Grbl versioning system
 #define GRBL_VERSION "1.1f"
 #define GRBL_VERSION_BUILD "20180919"
@@ -18,6 +23,8 @@
 #include <stdlib.h> // PSoc Required for labs
 
 #include "driver/timer.h"
+#include "driver/uart.h"
+#include "soc/gpio_struct.h"
 
 // Define the Grbl system include files. NOTE: Do not alter organization.
 #include "config.h"
@@ -40,8 +47,11 @@
 #include "serial.h"
 #include "stepper.h"
 #include "jog.h"
+#include "startup_cache.h"
 
 #ifdef ENABLE_BLUETOOTH
-#include "grbl_bluetooth.h"
 #include "BluetoothSerial.h"
+#include "grbl_bluetooth.h"
+#endif
+
 #endif
@@ -4,8 +4,18 @@
 
 BluetoothSerial SerialBT;
 
+// Called by the SPP driver after it queued received data for SerialBT.
+static void bluetooth_spp_callback(esp_spp_cb_event_t event, esp_spp_cb_param_t *param)
+{
+    if (event == ESP_SPP_DATA_IND_EVT)
+    {
+        serial_notify_rx();
+    }
+}
+
 void bluetooth_init(char *name)
 {
+    SerialBT.register_callback(bluetooth_spp_callback);
     if (!SerialBT.begin(name))
     {
         report_status_message(STATUS_BT_FAIL_BEGIN, CLIENT_SERIAL);
@@ -63,7 +63,7 @@ void limits_go_home(uint8_t cycle_mask)
     plan_line_data_t plan_data;
     plan_line_data_t *pl_data = &plan_data;
     memset(pl_data, 0, sizeof(plan_line_data_t));
-    pl_data->condition = (PL_COND_FLAG_SYSTEM_MOTION);
+    pl_data->condition = (PL_COND_FLAG_SYSTEM_MOTION | PL_COND_FLAG_NO_FEED_OVERRIDE);
 
     // Initialize variables used for homing computations.
     uint8_t n_cycle = (2 * N_HOMING_LOCATE_CYCLE + 1);
@@ -89,10 +89,12 @@ void limits_go_home(uint8_t cycle_mask)
     float homing_rate = settings.homing_seek_rate;
 
     uint8_t limit_state, axislock, n_active_axis;
+    int32_t current_position[N_AXIS];
     do
     {
 
-        system_convert_array_steps_to_mpos(target, sys_position);
+        st_get_realtime_position(current_position);
+        system_convert_array_steps_to_mpos(target, current_position);
 
         // Initialize and declare variables needed for homing routine.
         axislock = 0;
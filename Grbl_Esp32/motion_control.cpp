@@ -33,6 +33,17 @@ void mc_line(float *target, plan_line_data_t *pl_data)
     // If in check gcode mode, prevent motion by blocking planner. Soft limits still work.
     if (sys.state == STATE_CHECK_MODE)
     {
+#ifdef CHECK_MODE_ESTIMATE
+        // A run time estimate plans the motion, but executes it on the clock of the estimate.
+        if (st_estimate_running())
+        {
+            if (plan_check_full_buffer())
+            {
+                st_estimate_execute(false);
+            }
+            plan_buffer_line(target, pl_data);
+        }
+#endif
         return;
     }
 
@@ -82,6 +93,13 @@ void mc_dwell(float seconds)
 {
     if (sys.state == STATE_CHECK_MODE)
     {
+#ifdef CHECK_MODE_ESTIMATE
+        if (st_estimate_running())
+        {
+            protocol_buffer_synchronize();
+            st_estimate_dwell(seconds);
+        }
+#endif
         return;
     }
     protocol_buffer_synchronize();
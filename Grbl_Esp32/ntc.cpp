@@ -31,12 +31,14 @@ ntc::ntc()
 void ntc::printLocalTime()
 {
     struct tm timeinfo;
+    char text[64];
     if (!getLocalTime(&timeinfo))
     {
-        Serial.println("Failed to obtain time");
+        printf("Failed to obtain time\r\n");
         return;
     }
-    Serial.println(&timeinfo, "%A, %B %d %Y %H:%M:%S");
+    strftime(text, sizeof(text), "%A, %B %d %Y %H:%M:%S", &timeinfo);
+    printf("%s\r\n", text);
 }
 
 void ntc::initLocalTime()
@@ -46,7 +48,7 @@ void ntc::initLocalTime()
     while (WiFi.status() != WL_CONNECTED)
     {
         delay(500);
-        Serial.print(".");
+        printf(".");
     }
 
     configTime(hourOffset * 3600, 3600, ntp_server);
@@ -62,7 +64,7 @@ bool ntc::checkScheduler(uint8_t *plan)
     struct tm timeinfo;
     if (!getLocalTime(&timeinfo))
     {
-        Serial.println("Failed to obtain time");
+        printf("Failed to obtain time\r\n");
         return false;
     }
 
@@ -182,18 +182,24 @@ float convert_delta_vector_to_unit_vector(float *vector)
     return (magnitude);
 }
 
-float limit_value_by_axis_maximum(float *max_value, float *unit_vec)
+// Returns the largest value along unit_vec that keeps every axis within its maximum. Takes the
+// reciprocals of the axis maximums, so it divides only once. A zero maximum limits to zero.
+float limit_value_by_axis_inverse_maximum(float *inv_max_value, float *unit_vec)
 {
     uint8_t idx;
-    float limit_value = SOME_LARGE_VALUE;
+    float inv_limit_value = 0.0;
     for (idx = 0; idx < N_AXIS; idx++)
     {
-        if (unit_vec[idx] != 0)    // Avoid divide by zero.
+        if (unit_vec[idx] != 0)    // Avoid 0 * infinity of a zero maximum.
         {
-            limit_value = MIN(limit_value, fabs(max_value[idx] / unit_vec[idx]));
+            inv_limit_value = MAX(inv_limit_value, fabs(unit_vec[idx] * inv_max_value[idx]));
         }
     }
-    return (limit_value);
+    if (inv_limit_value == 0.0)
+    {
+        return (SOME_LARGE_VALUE);
+    }
+    return (1.0 / inv_limit_value);
 }
 
 // int constrain(int val, int min, int max) {
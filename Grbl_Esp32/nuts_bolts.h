@@ -56,7 +56,7 @@ void delay_ms(uint16_t ms);
 float hypot_f(float x, float y);
 
 float convert_delta_vector_to_unit_vector(float *vector);
-float limit_value_by_axis_maximum(float *max_value, float *unit_vec);
+float limit_value_by_axis_inverse_maximum(float *inv_max_value, float *unit_vec);
 
 //int constrain(int val, int min, int max);
 //long map(long x, long in_min, long in_max, long out_min, long out_max);
@@ -12,11 +12,18 @@
 
 
 
+#ifdef PLANNER_BUFFER_IN_PSRAM
+static plan_block_t *block_buffer = NULL;  // A ring buffer for motion instructions. Allocated by plan_reset().
+static plan_block_t block_buffer_fallback[BLOCK_BUFFER_FALLBACK_SIZE]; // Used when the allocation fails.
+static uint16_t block_buffer_size = BLOCK_BUFFER_SIZE;
+#else
 static plan_block_t block_buffer[BLOCK_BUFFER_SIZE];  // A ring buffer for motion instructions
-static uint8_t block_buffer_tail;     // Index of the block to process now
-static uint8_t block_buffer_head;     // Index of the next block to be pushed
-static uint8_t next_buffer_head;      // Index of the next buffer head
-static uint8_t block_buffer_planned;  // Index of the optimally planned block
+static const uint16_t block_buffer_size = BLOCK_BUFFER_SIZE;
+#endif
+static uint16_t block_buffer_tail;     // Index of the block to process now
+static uint16_t block_buffer_head;     // Index of the next block to be pushed
+static uint16_t next_buffer_head;      // Index of the next buffer head
+static uint16_t block_buffer_planned;  // Index of the optimally planned block
 
 // Define planner variables
 typedef struct
@@ -29,12 +36,17 @@ typedef struct
 } planner_t;
 static planner_t pl;
 
+#ifdef STEPPER_ISR_PROFILER
+// Written only by plan_buffer_line(), in the main program like the '$P' report.
+static plan_recalculate_profile_t recalculate_profile;
+#endif
+
 
 // Returns the index of the next block in the ring buffer. Also called by stepper segment buffer.
-uint8_t plan_next_block_index(uint8_t block_index)
+uint16_t plan_next_block_index(uint16_t block_index)
 {
     block_index++;
-    if (block_index == BLOCK_BUFFER_SIZE)
+    if (block_index == block_buffer_size)
     {
         block_index = 0;
     }
@@ -42,18 +54,118 @@ uint8_t plan_next_block_index(uint8_t block_index)
 }
 
 
+// Returns the step delta of the shortest way around a rotary axis of turn_steps per turn to the
+// same angle as delta. At most half a turn either way.
+static int32_t plan_rotary_shortest_delta(int32_t delta, int32_t turn_steps)
+{
+    delta %= turn_steps;
+    if (delta > (turn_steps / 2))
+    {
+        delta -= turn_steps;
+    }
+    else if (delta < -(turn_steps / 2))
+    {
+        delta += turn_steps;
+    }
+    return (delta);
+}
+
+
 // Returns the index of the previous block in the ring buffer
-static uint8_t plan_prev_block_index(uint8_t block_index)
+static uint16_t plan_prev_block_index(uint16_t block_index)
 {
     if (block_index == 0)
     {
-        block_index = BLOCK_BUFFER_SIZE;
+        block_index = block_buffer_size;
     }
     block_index--;
     return (block_index);
 }
 
 
+#ifdef JERK_LIMITED_ACCELERATION
+// Computes the distance of a jerk-limited speed change between speed_a and speed_b. The acceleration
+// rises at the jerk limit, holds at the acceleration limit when the speed change is large enough to
+// get there, and falls back to zero. The speed curve is point-symmetric, so the ramp covers its
+// average speed over its duration in either direction.
+float plan_ramp_distance(plan_block_t *block, float speed_a, float speed_b)
+{
+    float delta_speed = fabs(speed_b - speed_a);
+    if (block->jerk <= 0.0)   // No jerk limit. Constant acceleration.
+    {
+        return (delta_speed * (speed_a + speed_b) / (2.0 * block->acceleration));
+    }
+    float ramp_time;
+    if (delta_speed * block->jerk >= block->acceleration * block->acceleration)
+    {
+        ramp_time = delta_speed / block->acceleration + block->acceleration / block->jerk;
+    }
+    else     // Too short to reach the acceleration limit. Triangular acceleration.
+    {
+        ramp_time = 2.0 * sqrt(delta_speed / block->jerk);
+    }
+    return (0.5 * (speed_a + speed_b) * ramp_time);
+}
+
+// Inverse of plan_ramp_distance(). Computes the highest speed the block accelerates to from speed
+// within distance, which is also the highest speed it decelerates to speed from.
+float plan_ramp_speed(plan_block_t *block, float speed, float distance)
+{
+    if (distance <= 0.0)
+    {
+        return (speed);
+    }
+    if (block->jerk <= 0.0)
+    {
+        return (sqrt(speed * speed + 2 * block->acceleration * distance));
+    }
+    float jerk_time = block->acceleration / block->jerk; // Time to reach the acceleration limit (min)
+    float b = 2.0 * speed + block->acceleration * jerk_time;
+    float delta_speed;
+    if (distance >= b * jerk_time)
+    {
+        // Reaches the acceleration limit. Solves the quadratic in the speed change, in the form that
+        // keeps its precision for small changes.
+        float c = 2.0 * block->acceleration * (speed * jerk_time - distance);
+        delta_speed = -2.0 * c / (b + sqrt(b * b - 4.0 * c));
+    }
+    else
+    {
+        // Triangular acceleration over the jerk phase time u: distance = jerk*u^3 + 2*speed*u. Newton
+        // iterations from above converge monotonically.
+        float u = cbrt(distance / block->jerk);
+        if (speed > 0.0)
+        {
+            u = MIN(u, 0.5 * distance / speed);
+        }
+        uint8_t iterations;
+        for (iterations = 0; iterations < 4; iterations++)
+        {
+            float u_sqr = u * u;
+            u -= (block->jerk * u_sqr * u + 2.0 * speed * u - distance) / (3.0 * block->jerk * u_sqr + 2.0 * speed);
+        }
+        delta_speed = block->jerk * u * u;
+    }
+    return (speed + delta_speed);
+}
+#endif
+
+// Computes the highest squared speed a block reaches over its length from the squared speed at one
+// end, accelerating from its entry speed or, backwards, decelerating to its exit speed.
+static float plan_reachable_speed_sqr(plan_block_t *block, float speed_sqr)
+{
+#ifdef JERK_LIMITED_ACCELERATION
+    if (block->jerk > 0.0)
+    {
+        // The jerk-limited ramps of the segment generator need more distance. See plan_ramp_distance().
+        float speed = plan_ramp_speed(block, sqrt(speed_sqr), block->millimeters);
+        return (speed * speed);
+    }
+#endif
+    return (speed_sqr + 2 * block->acceleration * block->millimeters);
+}
+
+
 /*                            PLANNER SPEED DEFINITION
                                      +--------+   <- current->nominal_speed
                                     /          \
@@ -122,7 +234,7 @@ static uint8_t plan_prev_block_index(uint8_t block_index)
 static void planner_recalculate()
 {
     // Initialize block index to the last block in the planner buffer.
-    uint8_t block_index = plan_prev_block_index(block_buffer_head);
+    uint16_t block_index = plan_prev_block_index(block_buffer_head);
 
     // Bail. Can't do anything with one only one plan-able block.
     if (block_index == block_buffer_planned)
@@ -138,7 +250,7 @@ static void planner_recalculate()
     plan_block_t *current = &block_buffer[block_index];
 
     // Calculate maximum entry speed for last block in buffer, where the exit speed is always zero.
-    current->entry_speed_sqr = MIN( current->max_entry_speed_sqr, 2 * current->acceleration * current->millimeters);
+    current->entry_speed_sqr = MIN( current->max_entry_speed_sqr, plan_reachable_speed_sqr(current, 0.0));
 
     block_index = plan_prev_block_index(block_index);
     if (block_index == block_buffer_planned)   // Only two plannable blocks in buffer. Reverse pass complete.
@@ -166,7 +278,7 @@ static void planner_recalculate()
             // Compute maximum entry speed decelerating over the current block from its exit speed.
             if (current->entry_speed_sqr != current->max_entry_speed_sqr)
             {
-                entry_speed_sqr = next->entry_speed_sqr + 2 * current->acceleration * current->millimeters;
+                entry_speed_sqr = plan_reachable_speed_sqr(current, next->entry_speed_sqr);
                 if (entry_speed_sqr < current->max_entry_speed_sqr)
                 {
                     current->entry_speed_sqr = entry_speed_sqr;
@@ -193,7 +305,7 @@ static void planner_recalculate()
         // can improve the plan from the buffer tail to the planned pointer by logic.
         if (current->entry_speed_sqr < next->entry_speed_sqr)
         {
-            entry_speed_sqr = current->entry_speed_sqr + 2 * current->acceleration * current->millimeters;
+            entry_speed_sqr = plan_reachable_speed_sqr(current, current->entry_speed_sqr);
             // If true, current block is full-acceleration and we can move the planned pointer forward.
             if (entry_speed_sqr < next->entry_speed_sqr)
             {
@@ -217,6 +329,22 @@ static void planner_recalculate()
 
 void plan_reset()
 {
+#ifdef PLANNER_BUFFER_IN_PSRAM
+    if (block_buffer == NULL)
+    {
+        block_buffer = (plan_block_t *)ps_malloc(BLOCK_BUFFER_SIZE * sizeof(plan_block_t));
+        if (block_buffer == NULL)
+        {
+            block_buffer = (plan_block_t *)malloc(BLOCK_BUFFER_SIZE * sizeof(plan_block_t)); // No PSRAM.
+        }
+        if (block_buffer == NULL)
+        {
+            // No room on either heap. Plan with the short buffer of classic Grbl. '$I' reports the size.
+            block_buffer = block_buffer_fallback;
+            block_buffer_size = BLOCK_BUFFER_FALLBACK_SIZE;
+        }
+    }
+#endif
     memset(&pl, 0, sizeof(planner_t)); // Clear planner struct
     plan_reset_buffer();
 }
@@ -224,10 +352,12 @@ void plan_reset()
 
 void plan_reset_buffer()
 {
+    st_prep_lock();
     block_buffer_tail = 0;
     block_buffer_head = 0; // Empty = tail
     next_buffer_head = 1; // plan_next_block_index(block_buffer_head)
     block_buffer_planned = 0; // = block_buffer_tail;
+    st_prep_unlock();
 }
 
 
@@ -235,7 +365,7 @@ void plan_discard_current_block()
 {
     if (block_buffer_head != block_buffer_tail)   // Discard non-empty buffer.
     {
-        uint8_t block_index = plan_next_block_index( block_buffer_tail );
+        uint16_t block_index = plan_next_block_index( block_buffer_tail );
         // Push block_buffer_planned pointer, if encountered.
         if (block_buffer_tail == block_buffer_planned)
         {
@@ -266,7 +396,7 @@ plan_block_t *plan_get_current_block()
 
 float plan_get_exec_block_exit_speed_sqr()
 {
-    uint8_t block_index = plan_next_block_index(block_buffer_tail);
+    uint16_t block_index = plan_next_block_index(block_buffer_tail);
     if (block_index == block_buffer_head)
     {
         return ( 0.0 );
@@ -290,8 +420,16 @@ uint8_t plan_check_full_buffer()
 float plan_compute_profile_nominal_speed(plan_block_t *block)
 {
     float nominal_speed = block->programmed_rate;
-    if (!(block->condition & PL_COND_FLAG_RAPID_MOTION))
+    if (block->condition & PL_COND_FLAG_RAPID_MOTION)
+    {
+        nominal_speed *= (0.01 * sys.r_override);
+    }
+    else
     {
+        if (!(block->condition & PL_COND_FLAG_NO_FEED_OVERRIDE))
+        {
+            nominal_speed *= (0.01 * sys.f_override);
+        }
         if (nominal_speed > block->rapid_rate)
         {
             nominal_speed = block->rapid_rate;
@@ -328,7 +466,7 @@ static void plan_compute_profile_parameters(plan_block_t *block, float nominal_s
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
 void plan_update_velocity_profile_parameters()
 {
-    uint8_t block_index = block_buffer_tail;
+    uint16_t block_index = block_buffer_tail;
     plan_block_t *block;
     float nominal_speed;
     float prev_nominal_speed = SOME_LARGE_VALUE; // Set high for first block nominal speed calculation.
@@ -373,9 +511,20 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
         // Also, compute individual axes distance for move and prep unit vector calculations.
         // NOTE: Computes true distance from converted step values.
         target_steps[idx] = lround(target[idx] * settings.steps_per_mm[idx]);
+        if (settings_derived.rotary_steps[idx] && !(block->condition & PL_COND_FLAG_SYSTEM_MOTION))
+        {
+            // Rotary axis. Absolute targets take the shortest way around to the target angle. Incremental
+            // moves keep their distance, so a G91 move of a turn or more turns as often as asked. System
+            // motions, like the homing search, keep their full distance too.
+            if (block->condition & PL_COND_FLAG_ROTARY_SHORTEST)
+            {
+                target_steps[idx] = position_steps[idx] + plan_rotary_shortest_delta(target_steps[idx] - position_steps[idx],
+                                    settings_derived.rotary_steps[idx]);
+            }
+        }
         block->steps[idx] = labs(target_steps[idx] - position_steps[idx]);
         block->step_event_count = MAX(block->step_event_count, block->steps[idx]);
-        delta_mm = (target_steps[idx] - position_steps[idx]) / settings.steps_per_mm[idx];
+        delta_mm = (target_steps[idx] - position_steps[idx]) * settings_derived.mm_per_step[idx];
         unit_vec[idx] = delta_mm; // Store unit vector numerator
 
         // Set direction bits. Bit enabled always means direction is negative.
@@ -396,8 +545,26 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
     // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
     block->millimeters = convert_delta_vector_to_unit_vector(unit_vec);
-    block->acceleration = limit_value_by_axis_maximum(settings.acceleration, unit_vec);
-    block->rapid_rate = limit_value_by_axis_maximum(settings.max_rate, unit_vec);
+    block->acceleration = limit_value_by_axis_inverse_maximum(settings_derived.inv_acceleration, unit_vec);
+    block->rapid_rate = limit_value_by_axis_inverse_maximum(settings_derived.inv_max_rate, unit_vec);
+#ifdef STEP_RATE_GOVERNOR
+    // Limit the block to the step rate the stepper ISR sustains. Its dominant axis takes a step on
+    // every ISR tick at full speed. Programmed and nominal rates are capped by rapid_rate.
+    float step_rate_limited_rate = st_get_max_step_rate() * 60.0 * block->millimeters / block->step_event_count;
+    if ((step_rate_limited_rate > 0.0) && (block->rapid_rate > step_rate_limited_rate))
+    {
+        block->rapid_rate = step_rate_limited_rate;
+    }
+#endif
+#ifdef JERK_LIMITED_ACCELERATION
+    // Same as limit_value_by_axis_inverse_maximum(), except a zero axis jerk means unlimited, not zero.
+    float inv_jerk = 0.0;
+    for (idx = 0; idx < N_AXIS; idx++)
+    {
+        inv_jerk = MAX(inv_jerk, fabs(unit_vec[idx] * settings_derived.inv_jerk[idx]));
+    }
+    block->jerk = (inv_jerk > 0.0) ? (1.0 / inv_jerk) : 0.0;
+#endif
 
     // Store programmed rate.
     if (block->condition & PL_COND_FLAG_RAPID_MOTION)
@@ -471,7 +638,7 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
             else
             {
                 convert_delta_vector_to_unit_vector(junction_unit_vec);
-                float junction_acceleration = limit_value_by_axis_maximum(settings.acceleration, junction_unit_vec);
+                float junction_acceleration = limit_value_by_axis_inverse_maximum(settings_derived.inv_acceleration, junction_unit_vec);
                 float sin_theta_d2 = sqrt(0.5 * (1.0 - junction_cos_theta)); // Trig half angle identity. Always positive.
                 block->max_junction_speed_sqr = MAX( MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED,
                                                      (junction_acceleration * settings.junction_deviation * sin_theta_d2) / (1.0 - sin_theta_d2) );
@@ -491,15 +658,52 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
         memcpy(pl.position, target_steps, sizeof(target_steps)); // pl.position[] = target_steps[]
 
         // New block is all set. Update buffer head and next buffer head indices.
+        // NOTE: Locked, since the segment prep task may be reading the plan being recalculated.
+        st_prep_lock();
         block_buffer_head = next_buffer_head;
         next_buffer_head = plan_next_block_index(block_buffer_head);
 
         // Finish up by recalculating the plan with the new block.
+#ifdef STEPPER_ISR_PROFILER
+        // Both passes run over the blocks from the planned pointer to the new block.
+        uint16_t replanned_blocks = (block_buffer_head >= block_buffer_planned) ? (block_buffer_head - block_buffer_planned) :
+                                    (block_buffer_size - (block_buffer_planned - block_buffer_head));
+        uint32_t recalculate_start = xthal_get_ccount();
         planner_recalculate();
+        uint32_t recalculate_cycles = xthal_get_ccount() - recalculate_start;
+        recalculate_profile.count++;
+        recalculate_profile.total_cycles += recalculate_cycles;
+        recalculate_profile.total_blocks += replanned_blocks;
+        if (recalculate_cycles > recalculate_profile.max_cycles)
+        {
+            recalculate_profile.max_cycles = recalculate_cycles;
+        }
+        if (replanned_blocks > recalculate_profile.max_blocks)
+        {
+            recalculate_profile.max_blocks = replanned_blocks;
+        }
+#else
+        planner_recalculate();
+#endif
+        st_prep_unlock();
     }
     return (PLAN_OK);
 }
 
+bool plan_buffer_block(const plan_block_t *block)
+{
+    if (plan_check_full_buffer())
+    {
+        return (false);
+    }
+    st_prep_lock();
+    memcpy(&block_buffer[block_buffer_head], block, sizeof(plan_block_t));
+    block_buffer_head = next_buffer_head;
+    next_buffer_head = plan_next_block_index(block_buffer_head);
+    st_prep_unlock();
+    return (true);
+}
+
 // Reset the planner position vectors. Called by the system abort/initialization routine.
 void plan_sync_position()
 {
@@ -513,12 +717,69 @@ void plan_sync_position()
 }
 
 
+void plan_get_position(int32_t *position)
+{
+    memcpy(position, pl.position, sizeof(pl.position));
+}
+
+
+#ifdef STEPPER_ISR_PROFILER
+void plan_get_recalculate_profile(plan_recalculate_profile_t *profile)
+{
+    memcpy(profile, &recalculate_profile, sizeof(plan_recalculate_profile_t));
+}
+
+void plan_reset_recalculate_profile()
+{
+    memset(&recalculate_profile, 0, sizeof(plan_recalculate_profile_t));
+}
+#endif
+
+
+// Brings the position of rotary axes back into their first turn, by whole turns of steps.
+// Called when the machine goes idle, with the planner buffer empty. The turn lies within the
+// soft limit travel: 0 to -1 turn, or 0 to 1 turn for a positive travel with HOMING_FORCE_SET_ORIGIN.
+// The machine, planner and g-code positions are shifted together, so MPos, WPos and the targets
+// of the next g-code blocks all stay in one frame.
+void plan_normalize_rotary_position()
+{
+    uint8_t idx;
+    st_prep_lock();
+    for (idx = 0; idx < N_AXIS; idx++)
+    {
+        int32_t turn_steps = settings_derived.rotary_steps[idx];
+        if (turn_steps == 0)
+        {
+            continue;
+        }
+        bool positive_turn = false;
+#ifdef HOMING_FORCE_SET_ORIGIN
+        positive_turn = bit_istrue(settings.homing_dir_mask, bit(idx));
+#endif
+        int32_t position = sys_position[idx] % turn_steps; // Sign of sys_position.
+        if (positive_turn && (position < 0))
+        {
+            position += turn_steps;
+        }
+        else if (!positive_turn && (position > 0))
+        {
+            position -= turn_steps;
+        }
+        int32_t shift = sys_position[idx] - position;
+        sys_position[idx] -= shift;
+        pl.position[idx] -= shift;
+        gc_state.position[idx] -= shift * settings_derived.mm_per_step[idx];
+    }
+    st_prep_unlock();
+}
+
+
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available()
+uint16_t plan_get_block_buffer_available()
 {
     if (block_buffer_head >= block_buffer_tail)
     {
-        return ((BLOCK_BUFFER_SIZE - 1) - (block_buffer_head - block_buffer_tail));
+        return ((block_buffer_size - 1) - (block_buffer_head - block_buffer_tail));
     }
     return ((block_buffer_tail - block_buffer_head - 1));
 }
@@ -526,13 +787,19 @@ uint8_t plan_get_block_buffer_available()
 
 // Returns the number of active blocks are in the planner buffer.
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
-uint8_t plan_get_block_buffer_count()
+uint16_t plan_get_block_buffer_count()
 {
     if (block_buffer_head >= block_buffer_tail)
     {
         return (block_buffer_head - block_buffer_tail);
     }
-    return (BLOCK_BUFFER_SIZE - (block_buffer_tail - block_buffer_head));
+    return (block_buffer_size - (block_buffer_tail - block_buffer_head));
+}
+
+
+uint16_t plan_get_block_buffer_size()
+{
+    return (block_buffer_size);
 }
 
 
@@ -541,7 +808,9 @@ uint8_t plan_get_block_buffer_count()
 void plan_cycle_reinitialize()
 {
     // Re-plan from a complete stop. Reset planner entry speeds and buffer planned pointer.
+    st_prep_lock();
     st_update_plan_block_parameters();
     block_buffer_planned = block_buffer_tail;
     planner_recalculate();
+    st_prep_unlock();
 }
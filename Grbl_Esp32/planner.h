@@ -14,7 +14,24 @@
 
 // The number of linear motions that can be in the plan at any give time
 #ifndef BLOCK_BUFFER_SIZE
-#define BLOCK_BUFFER_SIZE 16
+#define BLOCK_BUFFER_SIZE 128
+#endif
+#if (BLOCK_BUFFER_SIZE < 2) || (BLOCK_BUFFER_SIZE > 65535)
+#error "BLOCK_BUFFER_SIZE must be 2 to 65535. Block indices are 16 bit."
+#endif
+// The internal RAM buffer PLANNER_BUFFER_IN_PSRAM falls back to, when no heap has room for the full one.
+#define BLOCK_BUFFER_FALLBACK_SIZE MIN(BLOCK_BUFFER_SIZE, 16)
+
+#ifdef STEPPER_ISR_PROFILER
+// Planner recalculations for new blocks. Times are in CPU cycles.
+typedef struct
+{
+    uint32_t count;         // Number of blocks added
+    uint64_t total_cycles;  // For the average
+    uint32_t max_cycles;
+    uint64_t total_blocks;  // Blocks replanned, for the average
+    uint16_t max_blocks;
+} plan_recalculate_profile_t;
 #endif
 
 // Returned status message from planner.
@@ -24,7 +41,9 @@
 // Define planner data condition flags. Used to denote running conditions of a block.
 #define PL_COND_FLAG_RAPID_MOTION      bit(0)
 #define PL_COND_FLAG_SYSTEM_MOTION     bit(1) // Single motion. Circumvents planner state. Used by home/park.
+#define PL_COND_FLAG_NO_FEED_OVERRIDE  bit(2) // Motion does not honor feed override.
 #define PL_COND_FLAG_INVERSE_TIME      bit(3) // Interprets feed rate value as inverse time when set.
+#define PL_COND_FLAG_ROTARY_SHORTEST   bit(4) // Rotary axes take the shortest way to the target angle. For G90 targets.
 #define PL_COND_MOTION_MASK    (PL_COND_FLAG_RAPID_MOTION|PL_COND_FLAG_SYSTEM_MOTION)
 
 
@@ -48,6 +67,9 @@ typedef struct
     float max_entry_speed_sqr; // Maximum allowable entry speed based on the minimum of junction limit and
     //   neighboring nominal speeds with overrides in (mm/min)^2
     float acceleration;        // Axis-limit adjusted line acceleration in (mm/min^2). Does not change.
+#ifdef JERK_LIMITED_ACCELERATION
+    float jerk;                // Axis-limit adjusted line jerk in (mm/min^3). 0 = unlimited. Does not change.
+#endif
     float millimeters;         // The remaining distance for this block to be executed in (mm).
     // NOTE: This value may be altered by stepper algorithm during execution.
 
@@ -76,6 +98,10 @@ void plan_reset_buffer(); // Reset buffer only.
 // rate is taken to mean "frequency" and would complete the operation in 1/feed_rate minutes.
 uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data);
 
+// Appends a copy of a block planned earlier, like a recorded one, without replanning. Returns false
+// if the buffer is full. Call plan_cycle_reinitialize() after the last one.
+bool plan_buffer_block(const plan_block_t *block);
+
 // Called when the current block is no longer needed. Discards the block and makes the memory
 // availible for new blocks.
 void plan_discard_current_block();
@@ -87,7 +113,7 @@ plan_block_t *plan_get_system_motion_block();
 plan_block_t *plan_get_current_block();
 
 // Called periodically by step segment buffer. Mostly used internally by planner.
-uint8_t plan_next_block_index(uint8_t block_index);
+uint16_t plan_next_block_index(uint16_t block_index);
 
 // Called by step segment buffer when computing executing block velocity profile.
 float plan_get_exec_block_exit_speed_sqr();
@@ -95,21 +121,45 @@ float plan_get_exec_block_exit_speed_sqr();
 // Called by main program during planner calculations and step segment buffer during initialization.
 float plan_compute_profile_nominal_speed(plan_block_t *block);
 
+#ifdef JERK_LIMITED_ACCELERATION
+// Distance of a jerk-limited speed change, and the highest speed reached within a distance. Shared by
+// the planner and the segment generator, so the plan fits the ramps the steppers execute.
+float plan_ramp_distance(plan_block_t *block, float speed_a, float speed_b);
+float plan_ramp_speed(plan_block_t *block, float speed, float distance);
+#endif
+
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
 void plan_update_velocity_profile_parameters();
 
 // Reset the planner position vector (in steps)
 void plan_sync_position();
 
+// Copies the planner position vector (in steps). The target of the last planned block.
+void plan_get_position(int32_t *position);
+
+// Brings rotary axes back into their first turn. Called when the machine goes idle.
+void plan_normalize_rotary_position();
+
 // Reinitialize plan with a partially completed block
 void plan_cycle_reinitialize();
 
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available();
+uint16_t plan_get_block_buffer_available();
+
+// Returns the number of blocks the planner buffer holds. BLOCK_BUFFER_SIZE, unless it was allocated smaller.
+uint16_t plan_get_block_buffer_size();
 
 // Returns the number of active blocks are in the planner buffer.
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
-uint8_t plan_get_block_buffer_count();
+uint16_t plan_get_block_buffer_count();
+
+#ifdef STEPPER_ISR_PROFILER
+// Copies the planner recalculation statistics. Called by the '$P' report.
+void plan_get_recalculate_profile(plan_recalculate_profile_t *profile);
+
+// Clears the planner recalculation statistics. Called by '$PR'.
+void plan_reset_recalculate_profile();
+#endif
 
 // Returns the status of the block ring buffer. True, if buffer is full.
 uint8_t plan_check_full_buffer();
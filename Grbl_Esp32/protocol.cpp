@@ -17,7 +17,15 @@
 #define LINE_FLAG_COMMENT_SEMICOLON bit(2)
 
 
-static char line[LINE_BUFFER_SIZE]; // Line to be executed. Zero-terminated.
+// Line assembly state of a client. Each client builds its lines separately, so a partial line
+// from one client is never joined with characters from another.
+typedef struct
+{
+    char line[LINE_BUFFER_SIZE]; // Line to be executed. Zero-terminated.
+    uint8_t char_counter;
+    uint8_t line_flags;
+} client_line_t;
+static client_line_t client_lines[CLIENT_COUNT];
 
 static void protocol_exec_rt_suspend();
 
@@ -63,8 +71,8 @@ void protocol_main_loop()
     // This is also where Grbl idles while waiting for something to do.
     // ---------------------------------------------------------------------------------
 
-    uint8_t line_flags = 0;
-    uint8_t char_counter = 0;
+    // Lines being received are discarded, like the contents of the serial read buffers on a reset.
+    memset(client_lines, 0, sizeof(client_lines));
     uint8_t c;
     bool led;
 
@@ -73,12 +81,15 @@ void protocol_main_loop()
 
         // serialCheck(); // un comment this if you do this here rather than in a separate task
 
-        // Process one line of incoming serial data, as the data becomes available. Performs an
-        // initial filtering by removing spaces and comments and capitalizing all letters.
-
-        uint8_t client = CLIENT_SERIAL;
-        for (client = 1; client <= CLIENT_COUNT; client++)
+        // Process the incoming serial data of the clients in turn, one line at a time, as the data
+        // becomes available. Performs an initial filtering by removing spaces and comments and
+        // capitalizing all letters. A client executes at most CLIENT_LINE_BUDGET lines before the
+        // next one is served, so a streaming client can not hold off the others.
+        bool data_pending = false;
+        for (uint8_t client = 1; client <= CLIENT_COUNT; client++)
         {
+            client_line_t *cl = &client_lines[client - 1];
+            uint8_t line_budget = CLIENT_LINE_BUDGET;
             while ((c = serial_read(client)) != SERIAL_NO_DATA)
             {
                 if ((c == '\n') || (c == '\r'))   // End of line reached
@@ -90,26 +101,26 @@ void protocol_main_loop()
                         return;  // Bail to calling function upon system abort
                     }
 
-                    line[char_counter] = 0; // Set string termination character.
+                    cl->line[cl->char_counter] = 0; // Set string termination character.
 #ifdef REPORT_ECHO_LINE_RECEIVED
-                    report_echo_line_received(line, client);
+                    report_echo_line_received(cl->line, client);
 #endif
 
                     // Direct and execute one line of formatted input, and report status of execution.
-                    if (line_flags & LINE_FLAG_OVERFLOW)
+                    if (cl->line_flags & LINE_FLAG_OVERFLOW)
                     {
                         // Report line overflow error.
                         report_status_message(STATUS_OVERFLOW, client);
                     }
-                    else if (line[0] == 0)
+                    else if (cl->line[0] == 0)
                     {
                         // Empty or comment line. For syncing purposes.
                         report_status_message(STATUS_OK, client);
                     }
-                    else if (line[0] == '$')
+                    else if (cl->line[0] == '$')
                     {
                         // Grbl '$' system command
-                        report_status_message(system_execute_line(line, client), client);
+                        report_status_message(system_execute_line(cl->line, client), client);
                     }
                     else if (sys.state & (STATE_ALARM | STATE_JOG))
                     {
@@ -119,26 +130,32 @@ void protocol_main_loop()
                     else
                     {
                         // Parse and execute g-code block.
-                        report_status_message(gc_execute_line(line, client), client);
+                        report_status_message(gc_execute_line(cl->line, client), client);
                     }
 
                     // Reset tracking data for next line.
-                    line_flags = 0;
-                    char_counter = 0;
+                    cl->line_flags = 0;
+                    cl->char_counter = 0;
+
+                    if (--line_budget == 0)
+                    {
+                        data_pending = true; // Any further lines wait for the other clients' turns.
+                        break;
+                    }
 
                 }
                 else
                 {
 
-                    if (line_flags)
+                    if (cl->line_flags)
                     {
                         // Throw away all (except EOL) comment characters and overflow characters.
                         if (c == ')')
                         {
                             // End of '()' comment. Resume line allowed.
-                            if (line_flags & LINE_FLAG_COMMENT_PARENTHESES)
+                            if (cl->line_flags & LINE_FLAG_COMMENT_PARENTHESES)
                             {
-                                line_flags &= ~(LINE_FLAG_COMMENT_PARENTHESES);
+                                cl->line_flags &= ~(LINE_FLAG_COMMENT_PARENTHESES);
                             }
                         }
                     }
@@ -160,12 +177,12 @@ void protocol_main_loop()
                             // NOTE: This doesn't follow the NIST definition exactly, but is good enough for now.
                             // In the future, we could simply remove the items within the comments, but retain the
                             // comment control characters, so that the g-code parser can error-check it.
-                            line_flags |= LINE_FLAG_COMMENT_PARENTHESES;
+                            cl->line_flags |= LINE_FLAG_COMMENT_PARENTHESES;
                         }
                         else if (c == ';')
                         {
                             // NOTE: ';' comment to EOL is a LinuxCNC definition. Not NIST.
-                            line_flags |= LINE_FLAG_COMMENT_SEMICOLON;
+                            cl->line_flags |= LINE_FLAG_COMMENT_SEMICOLON;
                             // TODO: Install '%' feature
                             // } else if (c == '%') {
                             // Program start-end percent sign NOT SUPPORTED.
@@ -174,18 +191,18 @@ void protocol_main_loop()
                             // everything until the next '%' sign. This will help fix resuming issues with certain
                             // functions that empty the planner buffer to execute its task on-time.
                         }
-                        else if (char_counter >= (LINE_BUFFER_SIZE - 1))
+                        else if (cl->char_counter >= (LINE_BUFFER_SIZE - 1))
                         {
                             // Detect line buffer overflow and set flag.
-                            line_flags |= LINE_FLAG_OVERFLOW;
+                            cl->line_flags |= LINE_FLAG_OVERFLOW;
                         }
                         else if (c >= 'a' && c <= 'z')     // Upcase lowercase
                         {
-                            line[char_counter++] = c - 'a' + 'A';
+                            cl->line[cl->char_counter++] = c - 'a' + 'A';
                         }
                         else
                         {
-                            line[char_counter++] = c;
+                            cl->line[cl->char_counter++] = c;
                         }
                     }
 
@@ -195,10 +212,13 @@ void protocol_main_loop()
 
 
 
-        // If there are no more characters in the serial read buffer to be processed and executed,
+        // If there are no more characters in the serial read buffers to be processed and executed,
         // this indicates that g-code streaming has either filled the planner buffer or has
         // completed. In either case, auto-cycle start, if enabled, any queued moves.
-        protocol_auto_cycle_start();
+        if (!data_pending)
+        {
+            protocol_auto_cycle_start();
+        }
 
         protocol_execute_realtime();  // Runtime command check point.
         if (sys.abort)
@@ -229,6 +249,16 @@ void protocol_main_loop()
 // during a synchronize call, if it should happen. Also, waits for clean cycle end.
 void protocol_buffer_synchronize()
 {
+#ifdef STARTUP_CACHE
+    st_record_abort(); // A recording of the startup blocks can not reproduce what happens after a sync.
+#endif
+#ifdef CHECK_MODE_ESTIMATE
+    if (st_estimate_running())
+    {
+        st_estimate_execute(true); // Check mode runs the motions of a run time estimate to their end.
+        return;
+    }
+#endif
     // If system is queued, ensure cycle resumes if the auto start flag is present.
     protocol_auto_cycle_start();
     do
@@ -458,6 +488,10 @@ void protocol_exec_rt_system()
                     gc_sync_position();
                     plan_sync_position();
                 }
+                if ((sys.state & (STATE_CYCLE | STATE_JOG)) && (plan_get_current_block() == NULL))
+                {
+                    plan_normalize_rotary_position();
+                }
                 sys.suspend = SUSPEND_DISABLE;
                 sys.state = STATE_IDLE;
 
@@ -466,6 +500,73 @@ void protocol_exec_rt_system()
         }
     }
 
+    // Execute overrides.
+    rt_exec = sys_rt_exec_motion_override; // Copy volatile sys_rt_exec_motion_override
+    if (rt_exec)
+    {
+        system_clear_exec_motion_overrides(); // Clear all motion override flags.
+
+        int16_t new_f_override = sys.f_override; // Signed so several decrements can not wrap around.
+        if (rt_exec & EXEC_FEED_OVR_RESET)
+        {
+            new_f_override = DEFAULT_FEED_OVERRIDE;
+        }
+        if (rt_exec & EXEC_FEED_OVR_COARSE_PLUS)
+        {
+            new_f_override += FEED_OVERRIDE_COARSE_INCREMENT;
+        }
+        if (rt_exec & EXEC_FEED_OVR_COARSE_MINUS)
+        {
+            new_f_override -= FEED_OVERRIDE_COARSE_INCREMENT;
+        }
+        if (rt_exec & EXEC_FEED_OVR_FINE_PLUS)
+        {
+            new_f_override += FEED_OVERRIDE_FINE_INCREMENT;
+        }
+        if (rt_exec & EXEC_FEED_OVR_FINE_MINUS)
+        {
+            new_f_override -= FEED_OVERRIDE_FINE_INCREMENT;
+        }
+        if (new_f_override > MAX_FEED_RATE_OVERRIDE)
+        {
+            new_f_override = MAX_FEED_RATE_OVERRIDE;
+        }
+        if (new_f_override < MIN_FEED_RATE_OVERRIDE)
+        {
+            new_f_override = MIN_FEED_RATE_OVERRIDE;
+        }
+
+        uint8_t new_r_override = sys.r_override;
+        if (rt_exec & EXEC_RAPID_OVR_RESET)
+        {
+            new_r_override = DEFAULT_RAPID_OVERRIDE;
+        }
+        if (rt_exec & EXEC_RAPID_OVR_MEDIUM)
+        {
+            new_r_override = RAPID_OVERRIDE_MEDIUM;
+        }
+        if (rt_exec & EXEC_RAPID_OVR_LOW)
+        {
+            new_r_override = RAPID_OVERRIDE_LOW;
+        }
+
+        if ((new_f_override != sys.f_override) || (new_r_override != sys.r_override))
+        {
+#ifdef STARTUP_CACHE
+            st_record_abort(); // The recorded segments would keep the speeds of the old override values.
+#endif
+            // Re-plan the queued blocks with the new nominal speeds. The executing block picks up the
+            // change through plan_cycle_reinitialize(), which restarts its profile from the current speed.
+            st_prep_lock();
+            sys.f_override = new_f_override;
+            sys.r_override = new_r_override;
+            sys.report_ovr_counter = 0; // Set to report change immediately
+            plan_update_velocity_profile_parameters();
+            plan_cycle_reinitialize();
+            st_prep_unlock();
+        }
+    }
+
 
     // Reload step segment buffer
     if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_HOMING | STATE_SLEEP | STATE_JOG))
@@ -20,6 +20,11 @@
 #define LINE_BUFFER_SIZE 80
 #endif
 
+// Lines a client may execute in a row while others wait. The main loop serves the clients in turn.
+#ifndef CLIENT_LINE_BUDGET
+#define CLIENT_LINE_BUDGET 4
+#endif
+
 // Starts Grbl main loop. It handles all incoming characters from the serial port and executes
 // them as they complete. It is also responsible for finishing the initialization procedures.
 void protocol_main_loop();
@@ -35,18 +35,16 @@
 
 
 // this is a generic send function that everything should use, so interfaces could be added (Bluetooth, etc)
-void grbl_send(uint8_t client, char *text)
+void grbl_send(uint8_t client, const char *text)
 {
 #ifdef ENABLE_BLUETOOTH
     if (SerialBT.hasClient() && ( client == CLIENT_BT || client == CLIENT_ALL ) )
     {
-
-        SerialBT.print(text);
-        //delay(10); // possible fix for dropped characters
+        serial_write_bytes(CLIENT_BT, text, strlen(text));
     }
 #endif
     if ( client == CLIENT_SERIAL || client == CLIENT_ALL )
-        Serial.print(text);
+        serial_write_bytes(CLIENT_SERIAL, text, strlen(text));
 }
 
 // This is a formating version of the grbl_send(CLIENT_ALL,...) function that work like printf
@@ -58,7 +56,7 @@ void grbl_sendf(uint8_t client, const char *format, ...)
     va_list copy;
     va_start(arg, format);
     va_copy(copy, arg);
-    size_t len = vsnprintf(NULL, 0, format, arg);
+    size_t len = vsnprintf(NULL, 0, format, copy); // Measuring consumes the list, so measure a copy.
     va_end(copy);
     if (len >= sizeof(loc_buf))
     {
@@ -71,7 +69,7 @@ void grbl_sendf(uint8_t client, const char *format, ...)
     len = vsnprintf(temp, len + 1, format, arg);
     grbl_send(client, temp);
     va_end(arg);
-    if (len > 64)
+    if (temp != loc_buf)
     {
         delete[] temp;
     }
@@ -191,6 +189,12 @@ void report_feedback_message(uint8_t message_code)  // OK to send to all clients
         case MESSAGE_SLEEP_MODE:
             grbl_send(CLIENT_ALL, "[MSG:Sleeping]\r\n");
             break;
+        case MESSAGE_STARTUP_RECORDED:
+            grbl_send(CLIENT_ALL, "[MSG:Startup recorded]\r\n");
+            break;
+        case MESSAGE_STARTUP_REPLAY:
+            grbl_send(CLIENT_ALL, "[MSG:Startup replay]\r\n");
+            break;
     }
 }
 
@@ -204,7 +208,17 @@ void report_init_message(uint8_t client)
 // Grbl help message
 void report_grbl_help(uint8_t client)
 {
-    grbl_send(client, "[HLP:$$ $# $G $I $N $x=val $Nx=line $J=line $SLP $C $X $H $F ~ ! ? ctrl-x]\r\n");
+    grbl_send(client, "[HLP:$$ $# $G $I $N $x=val $Nx=line $J=line $SLP $C $X $H $F"
+#ifdef STEPPER_ISR_PROFILER
+              " $P $PR"
+#endif
+#ifdef STEP_TRACE
+              " $T $TR"
+#endif
+#ifdef CHECK_MODE_ESTIMATE
+              " $CE"
+#endif
+              " ~ ! ? ctrl-x]\r\n");
 }
 
 
@@ -284,6 +298,14 @@ void report_grbl_settings(uint8_t client)
                     sprintf(setting, "$%d=%4.3f\r\n", val + idx, -settings.max_travel[idx]);
                     strcat(rpt, setting);
                     break;
+                case 4:
+                    sprintf(setting, "$%d=%4.3f\r\n", val + idx, settings.jerk[idx] / (60 * 60 * 60));
+                    strcat(rpt, setting);
+                    break;
+                case 5:
+                    sprintf(setting, "$%d=%4.3f\r\n", val + idx, settings.rotary_travel[idx]);
+                    strcat(rpt, setting);
+                    break;
             }
         }
         val += AXIS_SETTINGS_INCREMENT;
@@ -379,10 +401,13 @@ void report_execute_startup_message(char *line, uint8_t status_code, uint8_t cli
 // Prints build info line
 void report_build_info(char *line, uint8_t client)
 {
-    char build_info[50];
+    // The version prefix and the build info string of up to LINE_BUFFER_SIZE characters, which is set
+    // with $I, then up to 40 characters of fixed overhead: the [OPT: line with its option letters and
+    // the two buffer sizes, and the line ends.
+    char build_info[sizeof("[VER:" GRBL_VERSION "." GRBL_VERSION_BUILD ":") + LINE_BUFFER_SIZE + 40];
 
     strcpy(build_info, "[VER:" GRBL_VERSION "." GRBL_VERSION_BUILD ":");
-    strcat(build_info, line);
+    strncat(build_info, line, LINE_BUFFER_SIZE);
     strcat(build_info, "]\r\n[OPT:");
 
 #ifdef HOMING_FORCE_SET_ORIGIN
@@ -414,14 +439,147 @@ void report_build_info(char *line, uint8_t client)
 #endif
     // NOTE: Compiled values, like override increments/max/min values, may be added at some point later.
     // These will likely have a comma delimiter to separate them.
+    // Planner blocks and receive buffer bytes available to a sender, as Grbl 1.1 reports them.
+    size_t length = strlen(build_info);
+    snprintf(build_info + length, sizeof(build_info) - length, ",%d,%d", plan_get_block_buffer_size() - 1, RX_BUFFER_SIZE);
 
     strcat(build_info, "]\r\n");
     grbl_send(client, build_info); // ok to send to all
+#ifdef STEP_RATE_GOVERNOR
+    grbl_sendf(client, "[STEP:%u]\r\n", (uint32_t)st_get_max_step_rate()); // Measured maximum step rate in Hz.
+#endif
 }
 
 
 
 
+#ifdef STEPPER_ISR_PROFILER
+// Prints the stepper ISR execution statistics. Times are converted from CPU cycles to microseconds.
+// [ISR:ticks,min,avg,max,busy,late] followed by [ISRH:...] with the log2 cycle histogram bins.
+void report_isr_profile(uint8_t client)
+{
+    st_isr_profile_t profile;
+    char rpt[200];
+    char temp[20];
+    uint8_t idx;
+
+    st_get_isr_profile(&profile);
+    float cycles_per_us = ESP.getCpuFreqMHz();
+    float avg_cycles = 0.0;
+    if (profile.count)
+    {
+        avg_cycles = (float)profile.total_cycles / profile.count;
+    }
+
+    sprintf(rpt, "[ISR:%u,%4.2f,%4.2f,%4.2f,%u,%u]\r\n[ISRH:", profile.count,
+            profile.min_cycles / cycles_per_us, avg_cycles / cycles_per_us, profile.max_cycles / cycles_per_us,
+            profile.busy_count, profile.late_count);
+    for (idx = 0; idx < ISR_PROFILE_HISTOGRAM_BINS; idx++)
+    {
+        sprintf(temp, (idx < (ISR_PROFILE_HISTOGRAM_BINS - 1)) ? "%u," : "%u", profile.histogram[idx]);
+        strcat(rpt, temp);
+    }
+    strcat(rpt, "]\r\n");
+    grbl_send(client, rpt);
+
+    // Most segments ever queued, out of the usable segment buffer depth. Then segments per planner block.
+    st_segment_stats_t segment_stats;
+    st_get_segment_stats(&segment_stats);
+    float avg_block_segments = 0.0;
+    if (segment_stats.block_count)
+    {
+        avg_block_segments = (float)segment_stats.segment_count / segment_stats.block_count;
+    }
+    grbl_sendf(client, "[SEG:%u,%u]\r\n[SEGB:%u,%4.2f,%u,%u]\r\n", segment_stats.buffer_high_water, SEGMENT_BUFFER_SIZE - 1,
+               segment_stats.block_count, avg_block_segments, segment_stats.last_block_segments, segment_stats.max_block_segments);
+
+    // Ends of motion, normal and starved, then the fewest segments queued in the last cycle and in any cycle.
+    st_underrun_stats_t underrun_stats;
+    st_get_underrun_stats(&underrun_stats);
+    grbl_sendf(client, "[SEGU:%u,%u,%u,%u]\r\n", underrun_stats.stop_count, underrun_stats.starvation_count,
+               underrun_stats.cycle_min_depth, underrun_stats.min_depth);
+
+    // Planner recalculations for new blocks, their average and maximum time and blocks replanned.
+    plan_recalculate_profile_t plan_profile;
+    plan_get_recalculate_profile(&plan_profile);
+    float avg_plan_cycles = 0.0;
+    float avg_plan_blocks = 0.0;
+    if (plan_profile.count)
+    {
+        avg_plan_cycles = (float)plan_profile.total_cycles / plan_profile.count;
+        avg_plan_blocks = (float)plan_profile.total_blocks / plan_profile.count;
+    }
+    grbl_sendf(client, "[PLAN:%u,%4.2f,%4.2f,%4.2f,%u,%u]\r\n", plan_profile.count, avg_plan_cycles / cycles_per_us,
+               plan_profile.max_cycles / cycles_per_us, avg_plan_blocks, plan_profile.max_blocks, plan_get_block_buffer_size() - 1);
+}
+#endif
+
+#ifdef STEP_TRACE
+#define STEP_TRACE_LINE_ENTRIES 8 // Step pulses per [TR:] line
+
+// Prints the step pulse trace, oldest first. [TRC:pulses,dropped,cpu MHz] with the number of pulses
+// printed and of earlier pulses no longer kept, then [TR:...] lines of cycles:step bits:direction bits
+// per pulse. Cycles are counted from the previous pulse, so the first pulse of the trace shows 0.
+// Recording is held while printing.
+void report_step_trace(uint8_t client)
+{
+    st_step_trace_entry_t entry;
+    char rpt[200];
+    char temp[24];
+    uint32_t last_cycles = 0;
+
+    st_step_trace_hold(true);
+    uint32_t count = st_step_trace_count();
+    uint32_t first = (count > STEP_TRACE_SIZE) ? (count - STEP_TRACE_SIZE) : 0;
+    grbl_sendf(client, "[TRC:%u,%u,%u]\r\n", count - first, first, ESP.getCpuFreqMHz());
+    for (uint32_t n = first; n < count; n++)
+    {
+        st_step_trace_get(n, &entry);
+        if (((n - first) % STEP_TRACE_LINE_ENTRIES) == 0)
+        {
+            strcpy(rpt, "[TR:");
+        }
+        else
+        {
+            strcat(rpt, ",");
+        }
+        sprintf(temp, "%u:%u:%u", (n == first) ? 0 : (entry.cycles - last_cycles), entry.step_bits, entry.dir_bits);
+        strcat(rpt, temp);
+        last_cycles = entry.cycles;
+        if ((((n - first) % STEP_TRACE_LINE_ENTRIES) == (STEP_TRACE_LINE_ENTRIES - 1)) || (n == (count - 1)))
+        {
+            strcat(rpt, "]\r\n");
+            grbl_send(client, rpt);
+        }
+    }
+    st_step_trace_hold(false);
+}
+#endif
+
+#ifdef CHECK_MODE_ESTIMATE
+// Prints the run time estimate of a '$CE' check mode program. Times in seconds, rates in mm/min.
+// [EST:total,motion,dwell,blocks,peak path rate] [ESTR:peak rate of each axis]
+void report_run_time_estimate(uint8_t client)
+{
+    st_estimate_t estimate;
+    char rpt[100];
+    char temp[20];
+
+    st_get_estimate(&estimate);
+    float motion_time = (float)estimate.motion_ticks / F_STEPPER_TIMER;
+    grbl_sendf(client, "[EST:%4.3f,%4.3f,%4.3f,%u,%4.3f]\r\n", motion_time + estimate.dwell_time, motion_time,
+               estimate.dwell_time, estimate.block_count, estimate.peak_rate);
+    strcpy(rpt, "[ESTR:");
+    for (uint8_t idx = 0; idx < N_AXIS; idx++)
+    {
+        sprintf(temp, (idx == 0) ? "%4.3f" : ",%4.3f", estimate.peak_axis_rate[idx]);
+        strcat(rpt, temp);
+    }
+    strcat(rpt, "]\r\n");
+    grbl_send(client, rpt);
+}
+#endif
+
 // Prints the character string line Grbl has received from the user, which has been pre-parsed,
 // and has been sent into protocol_execute_line() routine to be executed by Grbl.
 void report_echo_line_received(char *line, uint8_t client)
@@ -438,7 +596,7 @@ void report_realtime_status(uint8_t client)
 {
     uint8_t idx;
     int32_t current_position[N_AXIS]; // Copy current state of the system position variable
-    memcpy(current_position, sys_position, sizeof(sys_position));
+    st_get_realtime_position(current_position);
     float print_position[N_AXIS];
 
     char status[200];
@@ -518,7 +676,9 @@ void report_realtime_status(uint8_t client)
 #ifdef REPORT_FIELD_BUFFER_STATE
     if (bit_istrue(settings.status_report_mask, BITFLAG_RT_STATUS_BUFFER_STATE))
     {
-        sprintf(temp, "|Bf:%d,%d", plan_get_block_buffer_available(), serial_get_rx_buffer_available(CLIENT_SERIAL));
+        // A report sent to all clients shows the USB serial buffer.
+        sprintf(temp, "|Bf:%u,%u", plan_get_block_buffer_available(),
+                serial_get_rx_buffer_available((client == CLIENT_ALL) ? CLIENT_SERIAL : client));
         strcat(status, temp);
     }
 #endif
@@ -530,6 +690,14 @@ void report_realtime_status(uint8_t client)
     strcat(status, temp);
 #endif
 
+#ifdef REPORT_FIELD_SEGMENT_UNDERRUN
+    // Segment buffer starvation stops and the fewest segments queued in the current or last cycle.
+    st_underrun_stats_t underrun_stats;
+    st_get_underrun_stats(&underrun_stats);
+    sprintf(temp, "|Un:%u,%u", underrun_stats.starvation_count, underrun_stats.cycle_min_depth);
+    strcat(status, temp);
+#endif
+
 #ifdef REPORT_FIELD_PIN_STATE
     uint8_t lim_pin_state = limits_get_state();
 
@@ -550,7 +718,25 @@ void report_realtime_status(uint8_t client)
     }
 #endif
 
-
+#ifdef REPORT_FIELD_OVERRIDES
+    if (sys.report_ovr_counter > 0)
+    {
+        sys.report_ovr_counter--;
+    }
+    else
+    {
+        sprintf(temp, "|Ov:%d,%d", sys.f_override, sys.r_override);
+        strcat(status, temp);
+        if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG))
+        {
+            sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT - 1); // Reset counter for slow refresh
+        }
+        else
+        {
+            sys.report_ovr_counter = (REPORT_OVR_REFRESH_IDLE_COUNT - 1);
+        }
+    }
+#endif
 
     strcat(status, ">\r\n");
 
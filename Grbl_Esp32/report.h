@@ -77,6 +77,8 @@
 #define MESSAGE_PROGRAM_END 8
 #define MESSAGE_RESTORE_DEFAULTS 9
 #define MESSAGE_SLEEP_MODE 11
+#define MESSAGE_STARTUP_RECORDED 12
+#define MESSAGE_STARTUP_REPLAY 13
 
 #define CLIENT_SERIAL 	1
 #define CLIENT_BT 			2
@@ -85,7 +87,7 @@
 #define CLIENT_COUNT    3 // total number of client types regardless if they are used
 
 // functions to send data to the user.
-void grbl_send(uint8_t client, char *text);
+void grbl_send(uint8_t client, const char *text);
 void grbl_sendf(uint8_t client, const char *format, ...);
 
 // Prints system status messages.
@@ -127,6 +129,21 @@ void report_execute_startup_message(char *line, uint8_t status_code, uint8_t cli
 // Prints build info and user info
 void report_build_info(char *line, uint8_t client);
 
+#ifdef STEPPER_ISR_PROFILER
+// Prints stepper ISR execution time statistics
+void report_isr_profile(uint8_t client);
+#endif
+
+#ifdef STEP_TRACE
+// Prints the step pulse trace
+void report_step_trace(uint8_t client);
+#endif
+
+#ifdef CHECK_MODE_ESTIMATE
+// Prints the run time estimate of a '$CE' check mode program
+void report_run_time_estimate(uint8_t client);
+#endif
+
 
 
 
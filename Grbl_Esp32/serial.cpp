@@ -10,29 +10,97 @@
 #define RX_RING_BUFFER (RX_BUFFER_SIZE+1)
 #define TX_RING_BUFFER (TX_BUFFER_SIZE+1)
 
-portMUX_TYPE myMutex = portMUX_INITIALIZER_UNLOCKED;
+// Each client's receive ring has a single producer, the serial task, which alone advances the head,
+// and a single consumer, the main loop, which alone advances the tail. The indices of the receive
+// and send rings are handed over with atomic loads and stores, so neither side needs a critical
+// section.
+#define ring_index_load(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define ring_index_store(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
 
 uint8_t serial_rx_buffer[CLIENT_COUNT][RX_RING_BUFFER];
-uint8_t serial_rx_buffer_head[CLIENT_COUNT] = {0};
-volatile uint8_t serial_rx_buffer_tail[CLIENT_COUNT] = {0};
+uint16_t serial_rx_buffer_head[CLIENT_COUNT] = {0};
+uint16_t serial_rx_buffer_tail[CLIENT_COUNT] = {0};
+
+#ifdef SERIAL_TX_TASK
+// Each client's send ring is filled by grbl_send(), from the main loop and the serial task, and
+// emptied by the send task. The writers hold the client's mutex while they copy, so the ring has a
+// single producer at a time and a message is never interleaved with another. A writer waits for room
+// on the client's space semaphore, which the send task gives whenever it frees space, without
+// holding the mutex.
+uint8_t serial_tx_buffer[CLIENT_COUNT][TX_RING_BUFFER];
+uint16_t serial_tx_buffer_head[CLIENT_COUNT] = {0};
+uint16_t serial_tx_buffer_tail[CLIENT_COUNT] = {0};
+static SemaphoreHandle_t serial_tx_mutex[CLIENT_COUNT];
+static SemaphoreHandle_t serial_tx_space[CLIENT_COUNT];
+static volatile bool serial_tx_stalled[CLIENT_COUNT]; // Set when a wait for room timed out. Cleared by the send task.
+static TaskHandle_t serialTxTaskHandle = 0;
+void serialTxTask(void *pvParameters);
+#endif
 
 
 // Returns the number of bytes available in the RX serial buffer.
-uint8_t serial_get_rx_buffer_available(uint8_t client)
+uint16_t serial_get_rx_buffer_available(uint8_t client)
 {
     uint8_t client_idx = client - 1;
 
-    uint8_t rtail = serial_rx_buffer_tail[client_idx]; // Copy to limit multiple calls to volatile
-    if (serial_rx_buffer_head[client_idx] >= rtail)
+    uint16_t rhead = ring_index_load(serial_rx_buffer_head[client_idx]);
+    uint16_t rtail = ring_index_load(serial_rx_buffer_tail[client_idx]);
+    if (rhead >= rtail)
     {
-        return (RX_BUFFER_SIZE - (serial_rx_buffer_head[client_idx] - rtail));
+        return (RX_BUFFER_SIZE - (rhead - rtail));
     }
-    return ((rtail - serial_rx_buffer_head[client_idx] - 1));
+    return ((rtail - rhead - 1));
 }
 
+#ifdef USE_UART_EVENT_QUEUE
+static QueueHandle_t uart_event_queue = NULL;
+static TaskHandle_t serialUartTaskHandle = 0;
+void serialUartTask(void *pvParameters);
+#endif
+
 void serial_init()
 {
+#ifdef USE_UART_EVENT_QUEUE
+    uart_config_t uart_config;
+    memset(&uart_config, 0, sizeof(uart_config_t));
+    uart_config.baud_rate = BAUD_RATE;
+    uart_config.data_bits = UART_DATA_8_BITS;
+    uart_config.parity = UART_PARITY_DISABLE;
+    uart_config.stop_bits = UART_STOP_BITS_1;
+    uart_config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    uart_param_config(UART_NUM_0, &uart_config);
+    // No driver TX buffer. Writes return once the bytes are in the hardware FIFO, like Serial.print().
+    uart_driver_install(UART_NUM_0, UART_DRIVER_RX_BUFFER_SIZE, 0, UART_EVENT_QUEUE_SIZE, &uart_event_queue, 0);
+
+    // create a task to read the UART, when the driver reports received data
+    xTaskCreatePinnedToCore(	serialUartTask,    // task
+                                "serialUartTask", // name for task
+                                2048 + UART_READ_CHUNK_SIZE,   // size of task stack
+                                NULL,   // parameters
+                                1, // priority
+                                &serialUartTaskHandle,
+                                0 // core
+                           );
+#else
     Serial.begin(BAUD_RATE);
+#endif
+
+#ifdef SERIAL_TX_TASK
+    for (uint8_t client_idx = 0; client_idx < CLIENT_COUNT; client_idx++)
+    {
+        serial_tx_mutex[client_idx] = xSemaphoreCreateRecursiveMutex();
+        serial_tx_space[client_idx] = xSemaphoreCreateBinary();
+    }
+    // create a task to write the queued output to the ports
+    xTaskCreatePinnedToCore(	serialTxTask,    // task
+                                "serialTxTask", // name for task
+                                2048,   // size of task stack
+                                NULL,   // parameters
+                                1, // priority
+                                &serialTxTaskHandle,
+                                0 // core
+                           );
+#endif
 
     // create a task to check for incoming data
     xTaskCreatePinnedToCore(	serialCheckTask,    // task
@@ -46,102 +114,184 @@ void serial_init()
 
 }
 
-
-// this task runs and checks for data on all interfaces
-// REaltime stuff is acted upon, then characters are added to the appropriate buffer
-void serialCheckTask(void *pvParameters)
+void serial_notify_rx()
 {
-    uint8_t data;
-    uint8_t next_head;
-    uint8_t client; // who send the data
+    if (serialCheckTaskHandle)
+    {
+        xTaskNotifyGive(serialCheckTaskHandle);
+    }
+}
 
-    uint8_t client_idx = 0;  // index of data buffer
 
-    while (true) // run continuously
+// True for the realtime command characters, which are acted upon by serial_execute_realtime()
+// instead of being added to the client buffers.
+static inline bool serial_is_realtime(uint8_t data)
+{
+    return ((data > 0x7F) || (data == CMD_RESET) || (data == CMD_STATUS_REPORT) || (data == CMD_CYCLE_START) ||
+            (data == CMD_FEED_HOLD));
+}
+
+static void serial_execute_realtime(uint8_t client, uint8_t data)
+{
+    // Pick off realtime command characters directly from the serial stream. These characters are
+    // not passed into the main buffer, but these set system state flag bits for realtime execution.
+    switch (data)
     {
-        while (Serial.available()
-#ifdef ENABLE_BLUETOOTH
-                || (SerialBT.hasClient() && SerialBT.available())
-#endif
-              )
-        {
-            client = CLIENT_SERIAL;
-            data = 0;
-            if (Serial.available())
+        case CMD_RESET:
+            mc_reset();   // Call motion control reset routine.
+            //report_init_message(client); // fool senders into thinking a reset happened.
+            break;
+        case CMD_STATUS_REPORT:
+            report_realtime_status(client);
+            break; // direct call instead of setting flag
+        case CMD_CYCLE_START:
+            system_set_exec_state_flag(EXEC_CYCLE_START);
+            break; // Set as true
+        case CMD_FEED_HOLD:
+            system_set_exec_state_flag(EXEC_FEED_HOLD);
+            break; // Set as true
+        default :
+            if (data > 0x7F)   // Real-time control characters are extended ACSII only.
             {
-                client = CLIENT_SERIAL;
-                data = Serial.read();
-            }
-            else
-            {
-                //currently is wifi or BT but better to prepare both can be live
-#ifdef ENABLE_BLUETOOTH
-                if (SerialBT.hasClient() && SerialBT.available())
+                switch (data)
                 {
-                    client = CLIENT_BT;
-                    data = SerialBT.read();
-                    //Serial.write(data);  // echo all data to serial
+                    case CMD_JOG_CANCEL:
+                        if (sys.state & STATE_JOG)   // Block all other states from invoking motion cancel.
+                        {
+                            system_set_exec_state_flag(EXEC_MOTION_CANCEL);
+                        }
+                        break;
+                    case CMD_FEED_OVR_RESET:
+                        system_set_exec_motion_override_flag(EXEC_FEED_OVR_RESET);
+                        break;
+                    case CMD_FEED_OVR_COARSE_PLUS:
+                        system_set_exec_motion_override_flag(EXEC_FEED_OVR_COARSE_PLUS);
+                        break;
+                    case CMD_FEED_OVR_COARSE_MINUS:
+                        system_set_exec_motion_override_flag(EXEC_FEED_OVR_COARSE_MINUS);
+                        break;
+                    case CMD_FEED_OVR_FINE_PLUS:
+                        system_set_exec_motion_override_flag(EXEC_FEED_OVR_FINE_PLUS);
+                        break;
+                    case CMD_FEED_OVR_FINE_MINUS:
+                        system_set_exec_motion_override_flag(EXEC_FEED_OVR_FINE_MINUS);
+                        break;
+                    case CMD_RAPID_OVR_RESET:
+                        system_set_exec_motion_override_flag(EXEC_RAPID_OVR_RESET);
+                        break;
+                    case CMD_RAPID_OVR_MEDIUM:
+                        system_set_exec_motion_override_flag(EXEC_RAPID_OVR_MEDIUM);
+                        break;
+                    case CMD_RAPID_OVR_LOW:
+                        system_set_exec_motion_override_flag(EXEC_RAPID_OVR_LOW);
+                        break;
+
                 }
-#else
-                return;
-#endif
+                // Throw away any unfound extended-ASCII character by not passing it to the serial buffer.
             }
+    }  // switch data
+}
 
-            client_idx = client - 1;  // for zero based array
+// Adds characters to the client's buffer. Characters that do not fit are dropped.
+static void serial_rx_push(uint8_t client, const uint8_t *data, size_t length)
+{
+    uint8_t client_idx = client - 1;  // for zero based array
 
-            // Pick off realtime command characters directly from the serial stream. These characters are
-            // not passed into the main buffer, but these set system state flag bits for realtime execution.
-            switch (data)
-            {
-                case CMD_RESET:
-                    mc_reset();   // Call motion control reset routine.
-                    //report_init_message(client); // fool senders into thinking a reset happened.
-                    break;
-                case CMD_STATUS_REPORT:
-                    report_realtime_status(client);
-                    break; // direct call instead of setting flag
-                case CMD_CYCLE_START:
-                    system_set_exec_state_flag(EXEC_CYCLE_START);
-                    break; // Set as true
-                case CMD_FEED_HOLD:
-                    system_set_exec_state_flag(EXEC_FEED_HOLD);
-                    break; // Set as true
-                default :
-                    if (data > 0x7F)   // Real-time control characters are extended ACSII only.
-                    {
-                        switch (data)
-                        {
-                            case CMD_JOG_CANCEL:
-                                if (sys.state & STATE_JOG)   // Block all other states from invoking motion cancel.
-                                {
-                                    system_set_exec_state_flag(EXEC_MOTION_CANCEL);
-                                }
-                                break;
+    size_t available = serial_get_rx_buffer_available(client);
+    if (length > available)
+    {
+        length = available;
+    }
+    if (length == 0)
+    {
+        return;
+    }
 
-                        }
-                        // Throw away any unfound extended-ASCII character by not passing it to the serial buffer.
-                    }
-                    else     // Write character to buffer
-                    {
-
-                        vTaskEnterCritical(&myMutex);
-                        next_head = serial_rx_buffer_head[client_idx] + 1;
-                        if (next_head == RX_RING_BUFFER)
-                        {
-                            next_head = 0;
-                        }
+    // Copy up to the end of the ring, then the rest to its start.
+    size_t head = serial_rx_buffer_head[client_idx]; // Only written here
+    size_t first = RX_RING_BUFFER - head;
+    if (first > length)
+    {
+        first = length;
+    }
+    memcpy(&serial_rx_buffer[client_idx][head], data, first);
+    memcpy(&serial_rx_buffer[client_idx][0], data + first, length - first);
+    head += length;
+    if (head >= RX_RING_BUFFER)
+    {
+        head -= RX_RING_BUFFER;
+    }
+    ring_index_store(serial_rx_buffer_head[client_idx], head); // Publishes the characters to the main loop.
+}
 
-                        // Write data to buffer unless it is full.
-                        if (next_head != serial_rx_buffer_tail[client_idx])
-                        {
-                            serial_rx_buffer[client_idx][serial_rx_buffer_head[client_idx]] = data;
-                            serial_rx_buffer_head[client_idx] = next_head;
-                        }
-                        vTaskExitCritical(&myMutex);
-                    }
-            }  // switch data
-        }  // if something available
-        vTaskDelay(1 / portTICK_RATE_MS);  // Yield to other tasks
+// Acts on the realtime command characters of received data and adds the runs of other characters
+// between them to the client's buffer.
+static void serial_rx_chunk(uint8_t client, const uint8_t *data, size_t length)
+{
+    size_t start = 0;
+    for (size_t n = 0; n < length; n++)
+    {
+        if (serial_is_realtime(data[n]))
+        {
+            serial_rx_push(client, &data[start], n - start);
+            serial_execute_realtime(client, data[n]);
+            start = n + 1;
+        }
+    }
+    serial_rx_push(client, &data[start], length - start);
+}
+
+// Acts on a realtime command character or adds the character to the client's buffer.
+static void serial_rx_byte(uint8_t client, uint8_t data)
+{
+    serial_rx_chunk(client, &data, 1);
+}
+
+
+#ifdef USE_UART_EVENT_QUEUE
+// Sleeps until the UART driver reports an event, then reads everything received so far in chunks.
+// A full driver buffer or hardware FIFO is read out the same way. The bytes lost to an overflow
+// can not be recovered, so the affected line fails to parse, like with the Arduino driver.
+void serialUartTask(void *pvParameters)
+{
+    uart_event_t event;
+    uint8_t chunk[UART_READ_CHUNK_SIZE];
+    int length;
+
+    while (true) // run continuously
+    {
+        if (!xQueueReceive(uart_event_queue, &event, portMAX_DELAY))
+        {
+            continue;
+        }
+        switch (event.type)
+        {
+            case UART_DATA:
+            case UART_BUFFER_FULL:
+            case UART_FIFO_OVF:
+                // Also reads the data of events still queued, whose reads then return nothing.
+                while ((length = uart_read_bytes(UART_NUM_0, chunk, sizeof(chunk), 0)) > 0)
+                {
+                    serial_rx_chunk(CLIENT_SERIAL, chunk, length);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+#endif
+
+// this task runs and checks for data on all interfaces
+// REaltime stuff is acted upon, then characters are added to the appropriate buffer
+void serialCheckTask(void *pvParameters)
+{
+    while (true) // run continuously
+    {
+        serialCheck();
+        // Sleep until an input driver reports received data. Wakes after SERIAL_POLL_TICKS at the
+        // latest, to poll the Arduino UART driver, which has no receive event.
+        ulTaskNotifyTake(pdTRUE, SERIAL_POLL_TICKS);
     }  // while(true)
 }
 
@@ -150,122 +300,171 @@ void serialCheckTask(void *pvParameters)
 // Realtime stuff is acted upon, then characters are added to the appropriate buffer
 void serialCheck()
 {
-    uint8_t data;
-    uint8_t next_head;
-    uint8_t client; // who send the data
-
-    uint8_t client_idx = 0;  // index of data buffer
-
-
-    while (Serial.available()
+#ifndef USE_UART_EVENT_QUEUE
+    while (Serial.available())
+    {
+        serial_rx_byte(CLIENT_SERIAL, Serial.read());
+    }
+#endif
 #ifdef ENABLE_BLUETOOTH
-            || (SerialBT.hasClient() && SerialBT.available())
+    //currently is wifi or BT but better to prepare both can be live
+    while (SerialBT.hasClient() && SerialBT.available())
+    {
+        serial_rx_byte(CLIENT_BT, SerialBT.read());
+    }
 #endif
-          )
+}
+
+// Empties the read buffer. Called by the main loop, the consumer, so it only moves the tail.
+void serial_reset_read_buffer(uint8_t client)
+{
+    for (uint8_t client_num = 1; client_num <= CLIENT_COUNT; client_num++)
     {
-        client = CLIENT_SERIAL;
-        data = 0;
-        if (Serial.available())
+        if (client == client_num || client == CLIENT_ALL)
         {
-            client = CLIENT_SERIAL;
-            data = Serial.read();
+            ring_index_store(serial_rx_buffer_tail[client_num - 1], ring_index_load(serial_rx_buffer_head[client_num - 1]));
         }
-        else
-        {
-            //currently is wifi or BT but better to prepare both can be live
-#ifdef ENABLE_BLUETOOTH
-            if (SerialBT.hasClient() && SerialBT.available())
-            {
-                client = CLIENT_BT;
-                data = SerialBT.read();
-            }
+    }
+}
+
+// Writes to the client's port. Returns once the driver has taken the data.
+static void serial_tx_output(uint8_t client, const char *data, size_t length)
+{
+    if (client == CLIENT_SERIAL)
+    {
+#ifdef USE_UART_EVENT_QUEUE
+        uart_write_bytes(UART_NUM_0, data, length);
 #else
-            return;
+        Serial.write((const uint8_t *)data, length);
 #endif
+    }
+#ifdef ENABLE_BLUETOOTH
+    else if (client == CLIENT_BT)
+    {
+        if (SerialBT.hasClient()) // Output queued for a client that has disconnected is dropped.
+        {
+            SerialBT.write((const uint8_t *)data, length);
         }
+    }
+#endif
+}
 
-        client_idx = client - 1;  // for zero based array
+#ifdef SERIAL_TX_TASK
+// Copies the data into the client's send ring and wakes the send task. When the ring is too full for
+// the message, waits up to SERIAL_TX_STALL_TIMEOUT for the send task to make room. A client whose
+// output does not drain in that time, like a Bluetooth peer that stopped reading, is marked stalled
+// and what does not fit is dropped without waiting until the send task writes again, so the writers,
+// and with them realtime replies, never block on it.
+static void serial_tx_push(uint8_t client, const char *data, size_t length)
+{
+    uint8_t client_idx = client - 1;  // for zero based array
+    bool waited = false;
 
-        // Pick off realtime command characters directly from the serial stream. These characters are
-        // not passed into the main buffer, but these set system state flag bits for realtime execution.
-        switch (data)
+    while (length > 0)
+    {
+        xSemaphoreTakeRecursive(serial_tx_mutex[client_idx], portMAX_DELAY);
+        uint16_t head = serial_tx_buffer_head[client_idx]; // Only written while holding the mutex
+        uint16_t tail = ring_index_load(serial_tx_buffer_tail[client_idx]);
+        size_t count = (head >= tail) ? (TX_BUFFER_SIZE - (head - tail)) : (tail - head - 1);
+        // Queue the message whole. Only a message longer than the ring is queued in parts.
+        if ((count >= length) || (count == TX_BUFFER_SIZE))
         {
-            case CMD_RESET:
-                mc_reset();
-                break; // Call motion control reset routine.
-            case CMD_STATUS_REPORT:
-                report_realtime_status(client);
-                break; // direct call instead of setting flag
-            case CMD_CYCLE_START:
-                system_set_exec_state_flag(EXEC_CYCLE_START);
-                break; // Set as true
-            case CMD_FEED_HOLD:
-                system_set_exec_state_flag(EXEC_FEED_HOLD);
-                break; // Set as true
-            default :
-                if (data > 0x7F)   // Real-time control characters are extended ACSII only.
-                {
-                    switch (data)
-                    {
-                        case CMD_JOG_CANCEL:
-                            if (sys.state & STATE_JOG)   // Block all other states from invoking motion cancel.
-                            {
-                                system_set_exec_state_flag(EXEC_MOTION_CANCEL);
-                            }
-                            break;
-                    }
-                    // Throw away any unfound extended-ASCII character by not passing it to the serial buffer.
-                }
-                else     // Write character to buffer
+            if (count > length)
+            {
+                count = length;
+            }
+            length -= count;
+            while (count > 0)
+            {
+                // Copy up to the end of the ring, then the rest from its start.
+                size_t part = (count > (size_t)(TX_RING_BUFFER - head)) ? (TX_RING_BUFFER - head) : count;
+                memcpy(&serial_tx_buffer[client_idx][head], data, part);
+                head += part;
+                if (head == TX_RING_BUFFER)
                 {
-
-
-                    next_head = serial_rx_buffer_head[client_idx] + 1;
-                    if (next_head == RX_RING_BUFFER)
-                    {
-                        next_head = 0;
-                    }
-
-                    // Write data to buffer unless it is full.
-                    if (next_head != serial_rx_buffer_tail[client_idx])
-                    {
-                        serial_rx_buffer[client_idx][serial_rx_buffer_head[client_idx]] = data;
-                        serial_rx_buffer_head[client_idx] = next_head;
-                    }
+                    head = 0;
                 }
-        }  // switch data
-    }  // if something available
+                data += part;
+                count -= part;
+            }
+            ring_index_store(serial_tx_buffer_head[client_idx], head); // Publishes the data to the send task.
+        }
+        xSemaphoreGiveRecursive(serial_tx_mutex[client_idx]);
+        xTaskNotifyGive(serialTxTaskHandle);
+        if (length == 0)
+        {
+            break;
+        }
+        if (serial_tx_stalled[client_idx] || (xSemaphoreTake(serial_tx_space[client_idx], pdMS_TO_TICKS(SERIAL_TX_STALL_TIMEOUT)) != pdTRUE))
+        {
+            serial_tx_stalled[client_idx] = true;
+            return; // Drops the rest of the message.
+        }
+        waited = true;
+    }
+    if (waited)
+    {
+        xSemaphoreGive(serial_tx_space[client_idx]); // Lets another waiting writer check the space too.
+    }
 }
 
-void serial_reset_read_buffer(uint8_t client)
+// Sleeps until output is queued, then writes everything queued for each client. Messages queued
+// while a write is in progress go out with the next write, so bursts of small messages, like the
+// responses to a stream of short lines, become a few large writes. Bluetooth sends a packet per
+// write and profits the most.
+void serialTxTask(void *pvParameters)
 {
-    for (uint8_t client_num = 1; client_num <= CLIENT_COUNT; client_num++)
+    while (true) // run continuously
     {
-        if (client == client_num || client == CLIENT_ALL)
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (uint8_t client_idx = 0; client_idx < CLIENT_COUNT; client_idx++)
         {
-            serial_rx_buffer_tail[client_num - 1] = serial_rx_buffer_head[client_num - 1];
+            uint16_t tail = serial_tx_buffer_tail[client_idx]; // Only written here
+            uint16_t head;
+            while ((head = ring_index_load(serial_tx_buffer_head[client_idx])) != tail)
+            {
+                // Write up to the head, or to the end of the ring when the data wraps around.
+                uint16_t end = (head > tail) ? head : TX_RING_BUFFER;
+                serial_tx_output(client_idx + 1, (const char *)&serial_tx_buffer[client_idx][tail], end - tail);
+                tail = (end == TX_RING_BUFFER) ? 0 : end;
+                ring_index_store(serial_tx_buffer_tail[client_idx], tail); // Frees the space for the writers.
+                serial_tx_stalled[client_idx] = false;
+                xSemaphoreGive(serial_tx_space[client_idx]);
+            }
         }
     }
 }
+#endif
+
+void serial_write_bytes(uint8_t client, const char *data, size_t length)
+{
+#ifdef SERIAL_TX_TASK
+    if (serialTxTaskHandle)
+    {
+        serial_tx_push(client, data, length);
+        return;
+    }
+#endif
+    serial_tx_output(client, data, length);
+}
 
 // Writes one byte to the TX serial buffer. Called by main program.
 void serial_write(uint8_t data)
 {
-    Serial.write((char)data);
+    serial_write_bytes(CLIENT_SERIAL, (const char *)&data, 1);
 }
 // Fetches the first byte in the serial read buffer. Called by main program.
 uint8_t serial_read(uint8_t client)
 {
     uint8_t client_idx = client - 1;
 
-    uint8_t tail = serial_rx_buffer_tail[client_idx]; // Temporary serial_rx_buffer_tail (to optimize for volatile)
-    if (serial_rx_buffer_head[client_idx] == tail)
+    uint16_t tail = serial_rx_buffer_tail[client_idx]; // Only written by the main program
+    if (ring_index_load(serial_rx_buffer_head[client_idx]) == tail)
     {
         return SERIAL_NO_DATA;
     }
     else
     {
-        vTaskEnterCritical(&myMutex); // make sure buffer is not modified while reading by newly read chars from the serial when we are here
         uint8_t data = serial_rx_buffer[client_idx][tail];
 
         tail++;
@@ -273,8 +472,7 @@ uint8_t serial_read(uint8_t client)
         {
             tail = 0;
         }
-        serial_rx_buffer_tail[client_idx] = tail;
-        vTaskExitCritical(&myMutex);
+        ring_index_store(serial_rx_buffer_tail[client_idx], tail); // Hands the byte back to the serial task.
         return data;
     }
 }
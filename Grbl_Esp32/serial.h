@@ -11,21 +11,41 @@
 #include "grbl.h"
 
 #ifndef RX_BUFFER_SIZE
-#define RX_BUFFER_SIZE 128
+#define RX_BUFFER_SIZE 1024
+#endif
+#if (RX_BUFFER_SIZE < 1) || (RX_BUFFER_SIZE > 65534)
+#error "RX_BUFFER_SIZE must be 1 to 65534. Buffer indices are 16 bit."
 #endif
 #ifndef TX_BUFFER_SIZE
-#define TX_BUFFER_SIZE 104
+#define TX_BUFFER_SIZE 1024
+#endif
+#if (TX_BUFFER_SIZE < 1) || (TX_BUFFER_SIZE > 65534)
+#error "TX_BUFFER_SIZE must be 1 to 65534. Buffer indices are 16 bit."
 #endif
 
 #define SERIAL_NO_DATA 0xff
 
+// Longest sleep of the serial task between two checks for received data, in FreeRTOS ticks. Input
+// drivers with a receive event wake it earlier with serial_notify_rx().
+#ifdef USE_UART_EVENT_QUEUE
+#define SERIAL_POLL_TICKS (100 / portTICK_PERIOD_MS) // Only a fallback. The UART has a task of its own.
+#else
+#define SERIAL_POLL_TICKS 1
+#endif
+
 // a task to read for incoming data from serial port
 static TaskHandle_t serialCheckTaskHandle = 0;
 void serialCheckTask(void *pvParameters);
 
 void serialCheck();
 
+// Wakes the serial task to pick up received data. Called by input driver callbacks.
+void serial_notify_rx();
+
 void serial_write(uint8_t data);
+// Writes data to a client's port. Queues it for the send task when there is one, otherwise writes it
+// directly. Called by grbl_send().
+void serial_write_bytes(uint8_t client, const char *data, size_t length);
 // Fetches the first byte in the serial read buffer. Called by main program.
 uint8_t serial_read(uint8_t client);
 
@@ -36,6 +56,6 @@ void serial_init();
 void serial_reset_read_buffer(uint8_t client);
 
 // Returns the number of bytes available in the RX serial buffer.
-uint8_t serial_get_rx_buffer_available(uint8_t client);
+uint16_t serial_get_rx_buffer_available(uint8_t client);
 
 #endif
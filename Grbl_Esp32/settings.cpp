@@ -10,6 +10,7 @@
 #include "grbl.h"
 
 settings_t settings;
+settings_derived_t settings_derived;
 
 // Method to store startup lines into EEPROM
 void settings_store_startup_line(uint8_t n, char *line)
@@ -25,12 +26,20 @@ void settings_init()
 {
     EEPROM.begin(EEPROM_SIZE);
 
-    if (!read_global_settings())
+    if (read_old_global_settings())
+    {
+        // Settings of an older version are kept. The startup lines and build info moved to make room
+        // for the larger settings record, which overlapped them, so those are cleared.
+        write_global_settings();
+        settings_restore(SETTINGS_RESTORE_STARTUP_LINES | SETTINGS_RESTORE_BUILD_INFO);
+    }
+    else if (!read_global_settings())
     {
         report_status_message(STATUS_SETTING_READ_FAIL, CLIENT_SERIAL);
         settings_restore(SETTINGS_RESTORE_ALL); // Force restore all EEPROM data.
         report_grbl_settings(CLIENT_SERIAL); // only the serial could be working at this point
     }
+    settings_update_derived();
 }
 
 // Method to restore EEPROM-saved Grbl global settings back to defaults.
@@ -82,8 +91,13 @@ void settings_restore(uint8_t restore_flag)
         settings.acceleration[Y_AXIS] = DEFAULT_Y_ACCELERATION;
         settings.max_travel[X_AXIS] = (-DEFAULT_X_MAX_TRAVEL);
         settings.max_travel[Y_AXIS] = (-DEFAULT_Y_MAX_TRAVEL);
+        settings.jerk[X_AXIS] = DEFAULT_X_JERK;
+        settings.jerk[Y_AXIS] = DEFAULT_Y_JERK;
+        settings.rotary_travel[X_AXIS] = DEFAULT_X_ROTARY_TRAVEL;
+        settings.rotary_travel[Y_AXIS] = DEFAULT_Y_ROTARY_TRAVEL;
 
         write_global_settings();
+        settings_update_derived();
     }
 
 
@@ -131,6 +145,42 @@ uint8_t read_global_settings()
     return (true);
 }
 
+// Reads the Grbl global settings struct of an older version from EEPROM, and fills in the axis
+// settings it lacks with their defaults. Version 10 lacks the jerk and the rotary travel, and
+// version 11 the rotary travel. Both sit right after max_travel, so the old record is the current
+// one without them. Returns false if EEPROM holds no record of a version it knows.
+uint8_t read_old_global_settings()
+{
+    char *added;
+    switch (EEPROM.read(0))
+    {
+        case 10:
+            added = (char*)settings.jerk;
+            break;
+        case 11:
+            added = (char*)settings.rotary_travel;
+            break;
+        default:
+            return (false);
+    }
+    uint16_t added_size = (char*)&settings.pulse_microseconds - added;
+    uint16_t old_size = sizeof(settings_t) - added_size;
+    if (!(memcpy_from_eeprom_with_checksum((char*)&settings, EEPROM_ADDR_GLOBAL, old_size)))
+    {
+        return (false);
+    }
+    memmove(added + added_size, added, old_size - (added - (char*)&settings));
+    memset(added, 0, added_size);
+    if (added == (char*)settings.jerk)
+    {
+        settings.jerk[X_AXIS] = DEFAULT_X_JERK;
+        settings.jerk[Y_AXIS] = DEFAULT_Y_JERK;
+    }
+    settings.rotary_travel[X_AXIS] = DEFAULT_X_ROTARY_TRAVEL;
+    settings.rotary_travel[Y_AXIS] = DEFAULT_Y_ROTARY_TRAVEL;
+    return (true);
+}
+
 // Method to store Grbl global settings struct and version number into EEPROM
 // NOTE: This function can only be called in IDLE state.
 void write_global_settings()
@@ -204,6 +254,12 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value)
                         {
                             return (STATUS_MAX_STEP_RATE_EXCEEDED);
                         }
+#endif
+#ifdef STEP_RATE_GOVERNOR
+                        if (value * settings.max_rate[parameter] > (st_get_max_step_rate() * 60.0))
+                        {
+                            return (STATUS_MAX_STEP_RATE_EXCEEDED);
+                        }
 #endif
                         settings.steps_per_mm[parameter] = value;
                         break;
@@ -213,6 +269,12 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value)
                         {
                             return (STATUS_MAX_STEP_RATE_EXCEEDED);
                         }
+#endif
+#ifdef STEP_RATE_GOVERNOR
+                        if (value * settings.steps_per_mm[parameter] > (st_get_max_step_rate() * 60.0))
+                        {
+                            return (STATUS_MAX_STEP_RATE_EXCEEDED);
+                        }
 #endif
                         settings.max_rate[parameter] = value;
                         break;
@@ -222,6 +284,12 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value)
                     case 3:
                         settings.max_travel[parameter] = -value;
                         break;  // Store as negative for grbl internal use.
+                    case 4:
+                        settings.jerk[parameter] = value * 60 * 60 * 60;
+                        break; // Convert to mm/min^3 for grbl internal use.
+                    case 5:
+                        settings.rotary_travel[parameter] = value;
+                        break;
                 }
                 break; // Exit while-loop after setting has been configured and proceed to the EEPROM write call.
             }
@@ -343,10 +411,26 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value)
         }
     }
     write_global_settings();
+    settings_update_derived();
     return (STATUS_OK);
 }
 
 
+void settings_update_derived()
+{
+    uint8_t idx;
+    for (idx = 0; idx < N_AXIS; idx++)
+    {
+        settings_derived.mm_per_step[idx] = 1.0 / settings.steps_per_mm[idx];
+        settings_derived.inv_max_rate[idx] = 1.0 / settings.max_rate[idx];
+        settings_derived.inv_acceleration[idx] = 1.0 / settings.acceleration[idx];
+        settings_derived.inv_jerk[idx] = (settings.jerk[idx] > 0.0) ? (1.0 / settings.jerk[idx]) : 0.0;
+        // NOTE: Exact only if a turn is a whole number of steps, like 360 degrees at 8 steps/degree.
+        settings_derived.rotary_steps[idx] = lround(settings.rotary_travel[idx] * settings.steps_per_mm[idx]);
+    }
+}
+
+
 
 
 // Returns step pin mask according to Grbl internal axis indexing.
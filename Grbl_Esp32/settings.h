@@ -15,7 +15,7 @@
 
 // Version of the EEPROM data. Will be used to migrate existing data from older versions of Grbl
 // when firmware is upgraded. Always stored in byte 0 of eeprom
-#define SETTINGS_VERSION 10  // NOTE: Check settings_reset() when moving to next version.
+#define SETTINGS_VERSION 12  // NOTE: Check settings_reset() and read_old_global_settings() when moving to next version.
 
 // Define bit flag masks for the boolean settings in settings.flag.
 #define BITFLAG_INVERT_ST_ENABLE   bit(2)
@@ -39,13 +39,14 @@
 
 // Define EEPROM memory address location values for Grbl settings and parameters
 #define EEPROM_SIZE				          1024U
+// NOTE: Each region is followed by a checksum byte. Startup lines take LINE_BUFFER_SIZE+1 bytes each.
 #define EEPROM_ADDR_GLOBAL          1U
-#define EEPROM_ADDR_BUILD_INFO      59U
-#define EEPROM_ADDR_STARTUP_BLOCK   61U
+#define EEPROM_ADDR_BUILD_INFO      90U
+#define EEPROM_ADDR_STARTUP_BLOCK   180U
 
 // Define Grbl axis settings numbering scheme. Starts at START_VAL, every INCREMENT, over N_SETTINGS.
-// from $100-101 to $130-131
-#define AXIS_N_SETTINGS          4
+// from $100-101 to $150-151
+#define AXIS_N_SETTINGS          6
 #define AXIS_SETTINGS_START_VAL  100 // NOTE: Reserving settings values >= 100 for axis settings. Up to 255.
 #define AXIS_SETTINGS_INCREMENT  10  // Must be greater than the number of axis settings
 
@@ -57,6 +58,8 @@ typedef struct
     float max_rate[N_AXIS];
     float acceleration[N_AXIS];
     float max_travel[N_AXIS];
+    float jerk[N_AXIS]; // (mm/min^3) 0 = unlimited. Used by JERK_LIMITED_ACCELERATION.
+    float rotary_travel[N_AXIS]; // (mm) Travel of one turn of a rotary axis. 0 = linear axis.
 
     // Remaining Grbl settings
     uint8_t pulse_microseconds;     //$0
@@ -74,7 +77,19 @@ typedef struct
     uint16_t homing_debounce_delay; //$26
     float homing_pulloff;           //$27
 } settings_t;
-extern settings_t settings; // SIZE 12*float + 7*char + 1*int16 = 57 byte
+extern settings_t settings; // SIZE 16*float + 7*char + 1*int16 = 73 byte
+
+// Values derived from the settings for the motion hot paths, so they multiply instead of divide.
+// Rebuilt by settings_update_derived() whenever the settings change. Not stored.
+typedef struct
+{
+    float mm_per_step[N_AXIS];      // 1/$100-$101
+    float inv_max_rate[N_AXIS];     // 1/$110-$111 in min/mm
+    float inv_acceleration[N_AXIS]; // 1/$120-$121 in min^2/mm
+    float inv_jerk[N_AXIS];         // 1/$140-$141 in min^3/mm. 0 = unlimited.
+    int32_t rotary_steps[N_AXIS];   // Steps per turn of $150-$151. 0 = linear axis.
+} settings_derived_t;
+extern settings_derived_t settings_derived;
 
 // Initialize the configuration subsystem (load settings from EEPROM)
 void settings_init();
@@ -82,6 +97,9 @@ void settings_restore(uint8_t restore_flag);
 void write_global_settings();
 uint8_t read_global_settings();
 
+// Reads the global settings of an older version, and brings them up to the current one
+uint8_t read_old_global_settings();
+
 uint8_t settings_read_startup_line(uint8_t n, char *line);
 void settings_store_startup_line(uint8_t n, char *line);
 
@@ -90,6 +108,9 @@ void settings_store_build_info(char *line);
 
 uint8_t settings_store_global_setting(uint8_t parameter, float value);
 
+// Rebuilds settings_derived from settings. Called whenever settings are loaded or changed.
+void settings_update_derived();
+
 // Returns the step pin mask according to Grbl's internal axis numbering
 uint8_t get_step_pin_mask(uint8_t i);
 
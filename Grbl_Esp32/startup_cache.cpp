@@ -0,0 +1,184 @@
+/*
+    startup_cache.cpp - Records and replays the step segments of the startup blocks
+    Part of Grbl_Esp32
+
+*/
+
+#include "grbl.h"
+#include <esp_partition.h>
+
+#ifdef STARTUP_CACHE
+
+#define STARTUP_CACHE_MAGIC 0x32435353 // "SSC2"
+#define STARTUP_CACHE_HASH_SEED 2166136261UL // FNV-1a offset basis
+#define STARTUP_CACHE_HASH_PRIME 16777619UL
+
+// Start of the partition. The recorded segment stream follows.
+typedef struct
+{
+    uint32_t magic;
+    uint32_t key;      // startup_cache_key() of the recorded startup blocks
+    uint32_t size;     // Stream length in bytes
+    uint32_t checksum; // Hash of the stream
+} startup_cache_header_t;
+
+// Recording, or the loaded recording while it is replayed. Allocated only meanwhile.
+static uint8_t *cache_buffer = NULL;
+
+static uint32_t startup_cache_hash(uint32_t hash, const void *data, uint32_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    while (size--)
+    {
+        hash ^= *(bytes++);
+        hash *= STARTUP_CACHE_HASH_PRIME;
+    }
+    return (hash);
+}
+
+static const esp_partition_t *startup_cache_partition()
+{
+    return (esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, STARTUP_CACHE_PARTITION));
+}
+
+static void startup_cache_free()
+{
+    free(cache_buffer);
+    cache_buffer = NULL;
+}
+
+// Runs the realtime protocol until all motion completed, including the resume of a feed hold.
+static void startup_cache_wait()
+{
+    protocol_auto_cycle_start();
+    do
+    {
+        protocol_execute_realtime();
+        if (sys.abort)
+        {
+            return;
+        }
+    }
+    while (plan_get_current_block() || (sys.state & (STATE_CYCLE | STATE_HOLD)));
+}
+
+uint32_t startup_cache_key()
+{
+    char line[LINE_BUFFER_SIZE];
+    const char *build = GRBL_VERSION "." GRBL_VERSION_BUILD " " __DATE__ " " __TIME__;
+    uint32_t key = startup_cache_hash(STARTUP_CACHE_HASH_SEED, build, strlen(build));
+    uint8_t n;
+    for (n = 0; n < N_STARTUP_LINE; n++)
+    {
+        if (!(settings_read_startup_line(n, line)))
+        {
+            line[0] = 0;
+        }
+        key = startup_cache_hash(key, line, strlen(line) + 1);
+    }
+    key = startup_cache_hash(key, &settings, sizeof(settings_t));
+    key = startup_cache_hash(key, &gc_state, sizeof(parser_state_t));
+    int32_t position[N_AXIS];
+    plan_get_position(position);
+    key = startup_cache_hash(key, position, sizeof(position));
+    return (key);
+}
+
+bool startup_cache_load(uint32_t key)
+{
+    const esp_partition_t *partition = startup_cache_partition();
+    startup_cache_header_t header;
+    if ((partition == NULL) || (esp_partition_read(partition, 0, &header, sizeof(header)) != ESP_OK))
+    {
+        return (false);
+    }
+    if ((header.magic != STARTUP_CACHE_MAGIC) || (header.key != key) || (header.size == 0) ||
+            (header.size > STARTUP_CACHE_SIZE) || (sizeof(header) + header.size > partition->size))
+    {
+        return (false);
+    }
+
+    cache_buffer = (uint8_t *)malloc(header.size);
+    if (cache_buffer == NULL)
+    {
+        return (false);
+    }
+    if ((esp_partition_read(partition, sizeof(header), cache_buffer, header.size) != ESP_OK) ||
+            (startup_cache_hash(STARTUP_CACHE_HASH_SEED, cache_buffer, header.size) != header.checksum) ||
+            !st_replay_start(cache_buffer, header.size))
+    {
+        startup_cache_free();
+        return (false);
+    }
+    return (true);
+}
+
+void startup_cache_replay()
+{
+    report_feedback_message(MESSAGE_STARTUP_REPLAY);
+
+    // Start the cycle, like a cycle start does for planner blocks.
+    sys.step_control = STEP_CONTROL_NORMAL_OP;
+    sys.state = STATE_CYCLE;
+    st_prep_buffer();
+    st_wake_up();
+    startup_cache_wait();
+
+    bool completed = st_replay_stop();
+    startup_cache_free();
+    if (sys.abort)
+    {
+        return; // The reset syncs all positions.
+    }
+    // The parser is at the end of the startup blocks. If motion was dropped, because a feed hold handed
+    // more blocks to the planner than it holds, the machine is not, so the parser follows the machine.
+    if (!completed)
+    {
+        gc_sync_position();
+    }
+    plan_sync_position();
+}
+
+void startup_cache_record_begin()
+{
+    cache_buffer = (uint8_t *)malloc(STARTUP_CACHE_SIZE);
+    if (cache_buffer)
+    {
+        st_record_start(cache_buffer, STARTUP_CACHE_SIZE);
+    }
+}
+
+void startup_cache_record_end(uint32_t key)
+{
+    if (cache_buffer == NULL)
+    {
+        return;
+    }
+    startup_cache_wait();
+    uint32_t size = st_record_stop();
+    const esp_partition_t *partition = startup_cache_partition();
+    if ((size == 0) || sys.abort || (sys.state != STATE_IDLE) || (partition == NULL) ||
+            (sizeof(startup_cache_header_t) + size > partition->size))
+    {
+        startup_cache_free();
+        return;
+    }
+
+    startup_cache_header_t header;
+    header.magic = STARTUP_CACHE_MAGIC;
+    header.key = key;
+    header.size = size;
+    header.checksum = startup_cache_hash(STARTUP_CACHE_HASH_SEED, cache_buffer, size);
+
+    // The stream is written before the header, so an interrupted write leaves no valid recording.
+    uint32_t erase_size = (sizeof(header) + size + SPI_FLASH_SEC_SIZE - 1) & ~(SPI_FLASH_SEC_SIZE - 1);
+    if ((esp_partition_erase_range(partition, 0, erase_size) == ESP_OK) &&
+            (esp_partition_write(partition, sizeof(header), cache_buffer, size) == ESP_OK) &&
+            (esp_partition_write(partition, 0, &header, sizeof(header)) == ESP_OK))
+    {
+        report_feedback_message(MESSAGE_STARTUP_RECORDED);
+    }
+    startup_cache_free();
+}
+
+#endif
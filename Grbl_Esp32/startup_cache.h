@@ -0,0 +1,33 @@
+/*
+    startup_cache.h - Records and replays the step segments of the startup blocks
+    Part of Grbl_Esp32
+
+    The first run of the startup blocks records the segments handed to the stepper ISR and stores
+    them in the STARTUP_CACHE_PARTITION flash partition, under a key that covers everything the
+    segments depend on. Later runs with the same key only parse the startup blocks and replay the
+    stored segments. See STARTUP_CACHE in config.h.
+*/
+
+#ifndef startup_cache_h
+#define startup_cache_h
+
+#include "grbl.h"
+
+// Returns the key of the current startup blocks. A hash of the blocks, all settings, the parser
+// state, the planner position and the firmware build. Call with the planner buffer empty.
+uint32_t startup_cache_key();
+
+// Loads the recording stored under key. Returns false if there is none, or it can not be replayed.
+bool startup_cache_load(uint32_t key);
+
+// Executes the loaded recording and waits until the motion completed. Call after parsing the
+// startup blocks in check mode, so the parser state matches the end of the recording.
+void startup_cache_replay();
+
+// Starts recording the segments of the startup blocks about to be executed.
+void startup_cache_record_begin();
+
+// Waits until the motion of the startup blocks completed and stores the recording under key.
+void startup_cache_record_end(uint32_t key);
+
+#endif
@@ -42,20 +42,17 @@ static segment_t segment_buffer[SEGMENT_BUFFER_SIZE];
 typedef struct
 {
     // Used by the bresenham line algorithm
-    uint32_t counter_x,        // Counter variables for the bresenham line tracer
-             counter_y,
-             counter_z;
-#ifdef STEP_PULSE_DELAY
-    uint8_t step_bits;  // Stores out_bits output to complete the step pulse delay
-#endif
-
+    uint32_t counter[N_AXIS];  // Counter variables for the bresenham line tracer
     uint8_t execute_step;     // Flags step execution for each interrupt.
-    uint8_t step_pulse_time;  // Step pulse reset time after step rise
+    uint16_t step_pulse_time; // Step pulse reset time after step rise, in stepper off timer ticks
     uint8_t step_outbits;         // The next stepping-bits to be output
     uint8_t dir_outbits;
 #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
     uint32_t steps[N_AXIS];
 #endif
+#ifdef SEGMENT_POSITION_ACCOUNTING
+    uint16_t segment_steps[N_AXIS]; // Steps executed per axis in the current segment. Direction is dir_outbits.
+#endif
 
     uint16_t step_count;       // Steps remaining in line segment motion
     uint8_t exec_block_index; // Tracks the current st_block index. Change indicates new block.
@@ -64,18 +61,171 @@ typedef struct
 } stepper_t;
 static stepper_t st;
 
-// Step segment ring buffer indices
-static volatile uint8_t segment_buffer_tail;
+// Step segment ring buffer indices. Single producer (st_prep_buffer) and single consumer (stepper ISR).
+// Only the producer writes the head and only the ISR writes the tail. Each publishes its index with a
+// release store after it is done with the segment, and reads the other's index with an acquire load,
+// so segment data is never seen before the index that hands it over, also when on different cores.
+static uint8_t segment_buffer_tail;
 static uint8_t segment_buffer_head;
 static uint8_t segment_next_head;
 
+#define segment_index_load(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define segment_index_store(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+// Returns the number of segments queued between the given ring indices.
+static inline uint8_t IRAM_ATTR st_segment_buffer_count(uint8_t head, uint8_t tail)
+{
+    if (head >= tail)
+    {
+        return (head - tail);
+    }
+    return (SEGMENT_BUFFER_SIZE - (tail - head));
+}
+
+#ifdef USE_SEGMENT_PREP_TASK
+// Refills the segment buffer when notified by the stepper ISR. See st_notify_segment_prep().
+static TaskHandle_t segmentPrepTaskHandle = 0;
+static SemaphoreHandle_t segment_prep_mutex = NULL;
+void segmentPrepTask(void *pvParameters);
+#endif
+static void st_fill_segment_buffer();
+static void st_resume_starved_cycle();
+#ifdef STARTUP_CACHE
+static void st_replay_segments();
+static void st_record_block();
+static void st_record_segment(segment_t *segment);
+#endif
+#ifdef CHECK_MODE_ESTIMATE
+static void st_estimate_segment(const segment_t *segment, float inv_rate);
+#endif
+
 // Step and direction port invert masks.
 static uint8_t step_port_invert_mask;
 static uint8_t dir_port_invert_mask;
 
+// Direct GPIO register pin map. The step and direction pins of cpu_map.h are resolved once into
+// W1TS (write one to set) and W1TC (write one to clear) masks for every possible axis bit pattern,
+// with the invert masks already applied, so the stepper ISR drives all axes with one register write
+// per bank instead of a digitalWrite() per pin. GPIO0-31 live in the low bank, GPIO32-39 in the high.
+// NOTE: Rebuilt by st_generate_step_dir_invert_masks() whenever $2 or $3 change.
+typedef struct
+{
+    uint32_t set_lo;  // GPIO.out_w1ts
+    uint32_t clr_lo;  // GPIO.out_w1tc
+    uint32_t set_hi;  // GPIO.out1_w1ts
+    uint32_t clr_hi;  // GPIO.out1_w1tc
+} gpio_out_map_t;
+static gpio_out_map_t step_pin_map[1 << N_AXIS];
+static gpio_out_map_t dir_pin_map[1 << N_AXIS];
+static bool step_pin_map_hi; // True when a step pin is in the high bank. Avoids needless writes.
+static bool dir_pin_map_hi;
+
+// Step and direction GPIO of each axis in cpu_map.h order, -1 where cpu_map.h defines no pin.
+// Indexed by axis, so only the first N_AXIS entries are used.
+#define ST_PIN_MAP_AXES 6 // X, Y, Z, A, B and C
+#if N_AXIS > ST_PIN_MAP_AXES
+#error "Step and direction pins are mapped for up to 6 axes."
+#endif
+#ifdef X_STEP_PIN
+#define X_STEP_GPIO X_STEP_PIN
+#else
+#define X_STEP_GPIO -1
+#endif
+#ifdef Y_STEP_PIN
+#define Y_STEP_GPIO Y_STEP_PIN
+#else
+#define Y_STEP_GPIO -1
+#endif
+#ifdef Z_STEP_PIN
+#define Z_STEP_GPIO Z_STEP_PIN
+#else
+#define Z_STEP_GPIO -1
+#endif
+#ifdef A_STEP_PIN
+#define A_STEP_GPIO A_STEP_PIN
+#else
+#define A_STEP_GPIO -1
+#endif
+#ifdef B_STEP_PIN
+#define B_STEP_GPIO B_STEP_PIN
+#else
+#define B_STEP_GPIO -1
+#endif
+#ifdef C_STEP_PIN
+#define C_STEP_GPIO C_STEP_PIN
+#else
+#define C_STEP_GPIO -1
+#endif
+#ifdef X_DIRECTION_PIN
+#define X_DIRECTION_GPIO X_DIRECTION_PIN
+#else
+#define X_DIRECTION_GPIO -1
+#endif
+#ifdef Y_DIRECTION_PIN
+#define Y_DIRECTION_GPIO Y_DIRECTION_PIN
+#else
+#define Y_DIRECTION_GPIO -1
+#endif
+#ifdef Z_DIRECTION_PIN
+#define Z_DIRECTION_GPIO Z_DIRECTION_PIN
+#else
+#define Z_DIRECTION_GPIO -1
+#endif
+#ifdef A_DIRECTION_PIN
+#define A_DIRECTION_GPIO A_DIRECTION_PIN
+#else
+#define A_DIRECTION_GPIO -1
+#endif
+#ifdef B_DIRECTION_PIN
+#define B_DIRECTION_GPIO B_DIRECTION_PIN
+#else
+#define B_DIRECTION_GPIO -1
+#endif
+#ifdef C_DIRECTION_PIN
+#define C_DIRECTION_GPIO C_DIRECTION_PIN
+#else
+#define C_DIRECTION_GPIO -1
+#endif
+static const int8_t step_gpio[ST_PIN_MAP_AXES] = { X_STEP_GPIO, Y_STEP_GPIO, Z_STEP_GPIO, A_STEP_GPIO, B_STEP_GPIO, C_STEP_GPIO };
+static const int8_t direction_gpio[ST_PIN_MAP_AXES] = { X_DIRECTION_GPIO, Y_DIRECTION_GPIO, Z_DIRECTION_GPIO,
+                                                        A_DIRECTION_GPIO, B_DIRECTION_GPIO, C_DIRECTION_GPIO };
+
+#ifdef USE_RMT_STEPS
+// RMT channel driving each axis step pin. The RMT generates the complete pulse (optional delay,
+// then $0 high time) from two items in its channel memory, so the ISR only requests a start.
+static const rmt_channel_t step_rmt_channel[ST_PIN_MAP_AXES] = { RMT_CHANNEL_0, RMT_CHANNEL_1, RMT_CHANNEL_2,
+                                                                 RMT_CHANNEL_3, RMT_CHANNEL_4, RMT_CHANNEL_5 };
+#endif
+
 // Used to avoid ISR nesting of the "Stepper Driver Interrupt". Should never occur though.
 static volatile uint8_t busy;
 
+#ifdef SEGMENT_POSITION_ACCOUNTING
+// Masks the stepper ISR while st_get_realtime_position() reads sys_position and the segment steps.
+static portMUX_TYPE realtime_position_mutex = portMUX_INITIALIZER_UNLOCKED;
+static void IRAM_ATTR st_fold_segment_position();
+#endif
+
+#ifdef STEPPER_ISR_PROFILER
+// Stepper driver interrupt execution statistics. Written only by the ISR, see st_reset_isr_profile().
+static st_isr_profile_t isr_profile;
+static portMUX_TYPE isr_profile_mutex = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+#ifdef STEP_TRACE
+// Ring of the last STEP_TRACE_SIZE step pulses. Written only by the ISR, unless held.
+static st_step_trace_entry_t step_trace[STEP_TRACE_SIZE];
+static volatile uint32_t step_trace_count; // Pulses recorded since the clear. Next entry modulo STEP_TRACE_SIZE.
+static volatile bool step_trace_held;
+static portMUX_TYPE step_trace_mutex = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+#ifdef STEP_RATE_GOVERNOR
+// Highest step rate the stepper ISR sustains, in Hz. Measured once by st_benchmark_step_rate().
+static float st_max_step_rate = 0.0;
+static portMUX_TYPE step_rate_benchmark_mutex = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
 // Pointers for the step segment being prepped from the planner buffer. Accessed only by the
 // main program. Pointers may be planning segments or planner blocks ahead of what being executed.
 static plan_block_t *pl_block;     // Pointer to the planner block being prepped
@@ -105,10 +255,174 @@ typedef struct
     float exit_speed;       // Exit speed of executing block (mm/min)
     float accelerate_until; // Acceleration ramp end measured from end of block (mm)
     float decelerate_after; // Deceleration ramp start measured from end of block (mm)
+    uint16_t block_segments; // Segments generated for the prepped planner block so far
+
+#ifdef JERK_LIMITED_ACCELERATION
+    // Jerk-limited shape of the current acceleration or deceleration ramp, in phases of constant jerk.
+    // The acceleration rises until ramp_rise_end, holds until ramp_fall_start and falls until
+    // ramp_time. See st_ramp_start().
+    float ramp_time;          // Duration of the ramp (min)
+    float ramp_elapsed;       // Ramp time prepped into the segment buffer so far (min)
+    float ramp_rise_end;      // (min)
+    float ramp_fall_start;    // (min)
+    float ramp_jerk;          // Jerk of the rising phase, negated in the falling phase (mm/min^3)
+    float ramp_accel;         // Acceleration at ramp_elapsed. Signed like the speed change (mm/min^2)
+#endif
 
 } st_prep_t;
 static st_prep_t prep;
 
+// Segment generator statistics. Written only by st_prep_buffer(), see st_get_segment_stats().
+static st_segment_stats_t segment_stats;
+
+// Segment buffer underrun statistics. Written only by the stepper ISR, see st_get_underrun_stats().
+// NOTE: The depth minimums start at the usable buffer depth, which means no segment was ever missing.
+static st_underrun_stats_t underrun_stats = { 0, 0, SEGMENT_BUFFER_SIZE - 1, SEGMENT_BUFFER_SIZE - 1 };
+static portMUX_TYPE underrun_stats_mutex = portMUX_INITIALIZER_UNLOCKED;
+
+#ifdef STARTUP_CACHE
+// Recorded segment stream, see st_record_start(). A sequence of entries, each a tag byte followed by
+// a st_block_t and the plan_block_t it was loaded from, or by a segment_t and the segment generator
+// state after it. A block entry precedes the segments executing it.
+#define ST_STREAM_BLOCK 'B'
+#define ST_STREAM_SEGMENT 'S'
+#define ST_STREAM_BLOCK_SIZE (sizeof(st_block_t) + sizeof(plan_block_t))
+#define ST_STREAM_SEGMENT_SIZE (sizeof(segment_t) + sizeof(st_stream_prep_t))
+typedef struct
+{
+    float mm_remaining;    // Distance to the end of the planner block (mm)
+    float steps_remaining;
+    float dt_remainder;
+    float current_speed;   // (mm/min)
+} st_stream_prep_t;
+typedef struct
+{
+    uint8_t *data;     // NULL when not recording or replaying
+    uint32_t size;     // Capacity when recording. Stream length when replaying.
+    uint32_t position; // Bytes recorded or replayed
+    bool failed;       // Recording overflowed or was interrupted. Replay dropped motion.
+    // Replay. Offset of the plan_block_t of the block being replayed, 0 before the first block, and the
+    // segment generator state at the end of the segments handed to the stepper ISR.
+    uint32_t block_position;
+    st_stream_prep_t prep;
+} st_stream_t;
+static st_stream_t st_record;
+static st_stream_t st_replay;
+#endif
+
+#ifdef CHECK_MODE_ESTIMATE
+// Run time estimate of a '$CE' check mode program, see st_estimate_start().
+static bool estimate_running;
+static st_estimate_t estimate;
+#endif
+
+// Set by the stepper ISR when it stopped on a starved segment buffer. The cycle stays running and the
+// next st_prep_buffer() restarts the ISR, see st_resume_starved_cycle().
+static volatile bool segment_buffer_starved;
+
+// st_segment_prep_exhausted() as of the last st_prep_buffer(), published for the stepper ISR. The ISR
+// reads only this flag, never the prep or planner state. It may lag behind a block queued since, in
+// which case the ISR ends the cycle on an empty buffer and the next cycle start picks the block up.
+static volatile bool segment_prep_exhausted;
+
+// True when the segment generator has no more segments to deliver for the current motion. Either the
+// motion was ended early, like by a feed hold, or the last planner block is completely in the segment
+// buffer. An empty segment buffer otherwise means the generator fell behind the ISR.
+// NOTE: Reads the prep and planner state, so only for the segment generator side. See above.
+static bool st_segment_prep_exhausted()
+{
+#ifdef STARTUP_CACHE
+    if (st_replay.data && !(sys.step_control & STEP_CONTROL_END_MOTION))
+    {
+        return (false);
+    }
+#endif
+    return ((sys.step_control & STEP_CONTROL_END_MOTION) || ((pl_block == NULL) && (plan_get_current_block() == NULL)));
+}
+
+// Lowers the segment buffer depth minimums of the current cycle. Called by the stepper ISR.
+static inline void IRAM_ATTR st_record_buffer_depth(uint8_t segments_queued)
+{
+    underrun_stats.cycle_min_depth = segments_queued;
+    if (segments_queued < underrun_stats.min_depth)
+    {
+        underrun_stats.min_depth = segments_queued;
+    }
+}
+
+// Per-axis work of the stepper driver interrupt. Each operation is a template over the axis index,
+// and st_for_each_axis expands it once per axis at compile time, so the ISR has no axis loop and
+// needs no edits when N_AXIS grows. Step and direction bits are the axis index, as in the pin maps.
+template <template <uint8_t> class axis_op, uint8_t axis_count = N_AXIS>
+struct st_for_each_axis
+{
+    static inline __attribute__((always_inline)) void run()
+    {
+        st_for_each_axis<axis_op, axis_count - 1>::run();
+        axis_op<axis_count - 1>::run();
+    }
+};
+
+template <template <uint8_t> class axis_op>
+struct st_for_each_axis<axis_op, 0>
+{
+    static inline __attribute__((always_inline)) void run() {}
+};
+
+// Starts the Bresenham counter of an axis half way, when a new block is loaded.
+template <uint8_t axis>
+struct st_axis_block_init
+{
+    static inline __attribute__((always_inline)) void run()
+    {
+        st.counter[axis] = (st.exec_block->step_event_count >> 1);
+    }
+};
+
+#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+// Scales the Bresenham axis increment to the AMASS level of a new segment.
+template <uint8_t axis>
+struct st_axis_amass_init
+{
+    static inline __attribute__((always_inline)) void run()
+    {
+        st.steps[axis] = st.exec_block->steps[axis] >> st.exec_segment->amass_level;
+    }
+};
+#endif
+
+// Advances the Bresenham counter of an axis by one step event. On overflow, sets the axis step bit
+// and counts the step in the machine position.
+template <uint8_t axis>
+struct st_axis_bresenham
+{
+    static inline __attribute__((always_inline)) void run()
+    {
+#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+        st.counter[axis] += st.steps[axis];
+#else
+        st.counter[axis] += st.exec_block->steps[axis];
+#endif
+        if (st.counter[axis] > st.exec_block->step_event_count)
+        {
+            st.step_outbits |= bit(axis);
+            st.counter[axis] -= st.exec_block->step_event_count;
+#ifdef SEGMENT_POSITION_ACCOUNTING
+            st.segment_steps[axis]++;
+#else
+            if (st.exec_block->direction_bits & bit(axis))
+            {
+                sys_position[axis]--;
+            }
+            else
+            {
+                sys_position[axis]++;
+            }
+#endif
+        }
+    }
+};
+
 
 /*  "The Stepper Driver Interrupt" - This timer interrupt is the workhorse of Grbl. Grbl employs
     the venerable Bresenham line algorithm to manage and exactly synchronize multi-axis moves.
@@ -152,7 +466,8 @@ static st_prep_t prep;
 
 	 NOTE: This interrupt must be as efficient as possible and complete before the next ISR tick,
     which for ESP32 Grbl must be less than xx.xusec (TBD). Oscilloscope measured time in
-    ISR is 5usec typical and 25usec maximum, well below requirement.
+    ISR is 5usec typical and 25usec maximum, well below requirement. With STEPPER_ISR_PROFILER
+    enabled, the '$P' command reports the measured time and any missed ticks on the unit itself.
     NOTE: This ISR expects at least one step to be executed per segment.
 
 	 The complete step timing should look this...
@@ -165,19 +480,28 @@ static st_prep_t prep;
 
 
 */
-// TODO: Replace direct updating of the int32 position counters in the ISR somehow. Perhaps use smaller
-// int8 variables and update position counters only when a segment completes. This can get complicated
-// with probing and homing cycles that require true real-time positions.
+// NOTE: With SEGMENT_POSITION_ACCOUNTING, the int32 position counters are no longer updated per step.
+// Steps are counted in per-segment accumulators and folded into sys_position when a segment completes.
+// Homing and status reports read the true real-time position with st_get_realtime_position().
 void IRAM_ATTR onStepperDriverTimer(void *para)  // ISR It is time to take a step =======================================================================================
 {
-    uint64_t step_pulse_off_time;
+    const int timer_idx = (intptr_t)para;  // get the timer index
 
-    const int timer_idx = (int)para;  // get the timer index
+#ifdef STEPPER_ISR_PROFILER
+    uint32_t isr_start_cycles = xthal_get_ccount();
+#endif
 
     TIMERG0.int_clr_timers.t0 = 1;
 
+#ifdef USE_SEGMENT_PREP_TASK
+    BaseType_t prep_task_woken = pdFALSE;
+#endif
+
     if (busy)
     {
+#ifdef STEPPER_ISR_PROFILER
+        isr_profile.busy_count++;
+#endif
         return;  // The busy-flag is used to avoid reentering this interrupt
     }
 
@@ -188,8 +512,22 @@ void IRAM_ATTR onStepperDriverTimer(void *para)  // ISR It is time to take a ste
 
 
     set_stepper_pins_on(st.step_outbits);
-    step_pulse_off_time = esp_timer_get_time() + (settings.pulse_microseconds); // determine when to turn off pulse
-
+#ifdef STEP_TRACE
+    if (st.step_outbits && !step_trace_held)
+    {
+        st_step_trace_entry_t *entry = &step_trace[step_trace_count & (STEP_TRACE_SIZE - 1)];
+        entry->cycles = xthal_get_ccount();
+        entry->step_bits = st.step_outbits;
+        entry->dir_bits = st.dir_outbits;
+        step_trace_count++;
+    }
+#endif
+#ifndef USE_RMT_STEPS
+    if (st.step_outbits)
+    {
+        Stepper_Off_Timer_Start(); // The Stepper Port Reset Interrupt ends the pulse.
+    }
+#endif
 
 
     busy = true;
@@ -197,7 +535,7 @@ void IRAM_ATTR onStepperDriverTimer(void *para)  // ISR It is time to take a ste
     if (st.exec_segment == NULL)
     {
         // Anything in the buffer? If so, load and initialize next step segment.
-        if (segment_buffer_head != segment_buffer_tail)
+        if (segment_index_load(segment_buffer_head) != segment_buffer_tail)
         {
             // Initialize new step segment and load number of steps to execute
             st.exec_segment = &segment_buffer[segment_buffer_tail];
@@ -214,14 +552,13 @@ void IRAM_ATTR onStepperDriverTimer(void *para)  // ISR It is time to take a ste
                 st.exec_block = &st_block_buffer[st.exec_block_index];
 
                 // Initialize Bresenham line and distance counters
-                st.counter_x = st.counter_y = st.counter_z = (st.exec_block->step_event_count >> 1);
+                st_for_each_axis<st_axis_block_init>::run();
             }
-            st.dir_outbits = st.exec_block->direction_bits ^ settings.dir_invert_mask;
+            st.dir_outbits = st.exec_block->direction_bits; // Invert mask is applied by the pin map.
 
 #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
             // With AMASS enabled, adjust Bresenham axis increment counters according to AMASS level.
-            st.steps[X_AXIS] = st.exec_block->steps[X_AXIS] >> st.exec_segment->amass_level;
-            st.steps[Y_AXIS] = st.exec_block->steps[Y_AXIS] >> st.exec_segment->amass_level;
+            st_for_each_axis<st_axis_amass_init>::run();
 #endif
 
 
@@ -229,8 +566,32 @@ void IRAM_ATTR onStepperDriverTimer(void *para)  // ISR It is time to take a ste
         else
         {
             // Segment buffer empty. Shutdown.
-            st_go_idle();
-            system_set_exec_state_flag(EXEC_CYCLE_STOP); // Flag main program for cycle end
+            if (segment_prep_exhausted)
+            {
+                st_go_idle();
+                underrun_stats.stop_count++;
+                system_set_exec_state_flag(EXEC_CYCLE_STOP); // Flag main program for cycle end
+            }
+            else
+            {
+                // Starved. There is still motion to execute, so the cycle is not over. Only stop the timer
+                // and wait for segments. The drivers stay as they are, idle handling is for the cycle end.
+                Stepper_Timer_Stop();
+                busy = false;
+                underrun_stats.starvation_count++;
+                st_record_buffer_depth(0);
+                segment_buffer_starved = true;
+#ifdef USE_SEGMENT_PREP_TASK
+                if (segmentPrepTaskHandle)
+                {
+                    vTaskNotifyGiveFromISR(segmentPrepTaskHandle, &prep_task_woken);
+                    if (prep_task_woken)
+                    {
+                        portYIELD_FROM_ISR();
+                    }
+                }
+#endif
+            }
             return; // Nothing to do but exit.
         }
     }
@@ -240,94 +601,296 @@ void IRAM_ATTR onStepperDriverTimer(void *para)  // ISR It is time to take a ste
     st.step_outbits = 0;
 
     // Execute step displacement profile by Bresenham line algorithm
-#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_x += st.steps[X_AXIS];
-#else
-    st.counter_x += st.exec_block->steps[X_AXIS];
+    st_for_each_axis<st_axis_bresenham>::run();
+
+    // During a homing cycle, lock out and prevent desired axes from moving.
+    if (sys.state == STATE_HOMING)
+    {
+        st.step_outbits &= sys.homing_axis_lock;
+    }
+
+    st.step_count--; // Decrement step events count
+    if (st.step_count == 0)
+    {
+        // Segment is complete. Discard current segment and advance segment indexing.
+#ifdef SEGMENT_POSITION_ACCOUNTING
+        st_fold_segment_position();
+#endif
+        st.exec_segment = NULL;
+        uint8_t tail = segment_buffer_tail + 1;
+        if (tail == SEGMENT_BUFFER_SIZE)
+        {
+            tail = 0;
+        }
+        segment_index_store(segment_buffer_tail, tail); // Hand the segment back to the producer.
+        uint8_t segments_queued = st_segment_buffer_count(segment_index_load(segment_buffer_head), tail);
+        // NOTE: The buffer drains at every end of motion. Only depths while segments are still due count.
+        if ((segments_queued < underrun_stats.cycle_min_depth) && !segment_prep_exhausted)
+        {
+            st_record_buffer_depth(segments_queued);
+        }
+#ifdef USE_SEGMENT_PREP_TASK
+        // Wake the segment prep task, once the buffer has drained to the low-water mark.
+        if ((segments_queued < SEGMENT_BUFFER_LOW_WATER) && segmentPrepTaskHandle)
+        {
+            vTaskNotifyGiveFromISR(segmentPrepTaskHandle, &prep_task_woken);
+        }
+#endif
+    }
+
+    // NOTE: Step port invert mask is applied by the pin map in set_stepper_pins_on().
+
+
+    TIMERG0.hw_timer[STEP_TIMER_INDEX].config.alarm_en = TIMER_ALARM_EN;
+
+#ifdef STEPPER_ISR_PROFILER
+    // The timer auto-reloads at the alarm, so a counter at or past the alarm value means the
+    // period written for the next tick was already over by the time this ISR finished.
+    TIMERG0.hw_timer[STEP_TIMER_INDEX].update = 1;
+    if (TIMERG0.hw_timer[STEP_TIMER_INDEX].cnt_low >= TIMERG0.hw_timer[STEP_TIMER_INDEX].alarm_low)
+    {
+        isr_profile.late_count++;
+    }
+    uint32_t isr_cycles = xthal_get_ccount() - isr_start_cycles;
+    if (isr_cycles < isr_profile.min_cycles || isr_profile.count == 0)
+    {
+        isr_profile.min_cycles = isr_cycles;
+    }
+    if (isr_cycles > isr_profile.max_cycles)
+    {
+        isr_profile.max_cycles = isr_cycles;
+    }
+    isr_profile.total_cycles += isr_cycles;
+    isr_profile.count++;
+    uint8_t bin = 31 - __builtin_clz(isr_cycles | 1); // log2
+    if (bin >= ISR_PROFILE_HISTOGRAM_BINS)
+    {
+        bin = ISR_PROFILE_HISTOGRAM_BINS - 1;
+    }
+    isr_profile.histogram[bin]++;
+#endif
+
+    busy = false;
+
+#ifdef USE_SEGMENT_PREP_TASK
+    if (prep_task_woken)
+    {
+        portYIELD_FROM_ISR(); // Run the segment prep task right after this ISR, not at the next tick.
+    }
 #endif
-    if (st.counter_x > st.exec_block->step_event_count)
+}
+
+
+/*  The Stepper Port Reset Interrupt: Timer 1 of the stepper timer group is armed as a one-shot by
+    the stepper driver interrupt after each step pulse rise and fires once the $0 pulse time has
+    elapsed, clearing the step pins. This replaces spinning on esp_timer_get_time() inside the
+    driver interrupt, so the pulse length no longer adds to the driver interrupt execution time.
+    NOTE: The pulse must end before the next stepper driver tick. Since the step rate is always
+    far below 1/$0, a newer pulse just re-arms the timer and is never cut short.
+*/
+void IRAM_ATTR onStepperOffTimer(void *para)
+{
+    TIMERG0.int_clr_timers.t1 = 1;
+    TIMERG0.hw_timer[STEP_OFF_TIMER_INDEX].config.enable = 0;
+    set_stepper_pins_on(0); // Reset step pins to their idle level.
+}
+
+#ifdef SEGMENT_POSITION_ACCOUNTING
+// Adds the steps executed in the current segment to the machine position and clears the
+// accumulators. Called by the stepper ISR at segment completion and when the steppers stop.
+static void IRAM_ATTR st_fold_segment_position()
+{
+    uint8_t idx;
+    for (idx = 0; idx < N_AXIS; idx++)
     {
-        st.step_outbits |= (1 << X_STEP_BIT);
-        st.counter_x -= st.exec_block->step_event_count;
-        if (st.exec_block->direction_bits & (1 << X_DIRECTION_BIT))
+        if (st.dir_outbits & bit(idx))
         {
-            sys_position[X_AXIS]--;
+            sys_position[idx] -= st.segment_steps[idx];
         }
         else
         {
-            sys_position[X_AXIS]++;
+            sys_position[idx] += st.segment_steps[idx];
         }
+        st.segment_steps[idx] = 0;
     }
-#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_y += st.steps[Y_AXIS];
-#else
-    st.counter_y += st.exec_block->steps[Y_AXIS];
+}
 #endif
-    if (st.counter_y > st.exec_block->step_event_count)
+
+// Returns the real-time machine position in steps, including the steps already executed in the
+// segment in progress. Use this instead of reading sys_position while the steppers may be running.
+// NOTE: Like the ISR profile, the critical section masks the stepper ISR, which steps and folds
+// the segment steps, so the position, the segment steps and the direction bits are read together.
+void st_get_realtime_position(int32_t *position)
+{
+#ifdef SEGMENT_POSITION_ACCOUNTING
+    uint8_t idx;
+    vTaskEnterCritical(&realtime_position_mutex);
+    for (idx = 0; idx < N_AXIS; idx++)
     {
-        st.step_outbits |= (1 << Y_STEP_BIT);
-        st.counter_y -= st.exec_block->step_event_count;
-        if (st.exec_block->direction_bits & (1 << Y_DIRECTION_BIT))
+        if (st.dir_outbits & bit(idx))
         {
-            sys_position[Y_AXIS]--;
+            position[idx] = sys_position[idx] - st.segment_steps[idx];
         }
         else
         {
-            sys_position[Y_AXIS]++;
+            position[idx] = sys_position[idx] + st.segment_steps[idx];
         }
     }
+    vTaskExitCritical(&realtime_position_mutex);
+#else
+    memcpy(position, sys_position, sizeof(sys_position));
+#endif
+}
 
-    // During a homing cycle, lock out and prevent desired axes from moving.
-    if (sys.state == STATE_HOMING)
+#ifdef STEP_RATE_GOVERNOR
+// Runs the stepper ISR on a synthetic motion and sets st_max_step_rate from its average cost per tick.
+// Every axis steps on every tick and every segment starts a new block, which is the worst case of the
+// Bresenham, AMASS and segment loading paths. The step bits are real, so the pulse reset timer, its
+// interrupt and the step trace cost what they do in a cycle. Empty pin maps keep the pins as they are,
+// at the cost of the same register writes, and the RMT is not routed to the step pins yet. The direct
+// calls skip the interrupt entry and exit, which STEP_RATE_GOVERNOR_ISR_ENTRY_CYCLES adds per interrupt.
+// Called by stepper_init(), before the step timer runs and the segment prep task exists, so nothing else
+// touches the stepper state. Interrupts are only masked while a segment runs, a chunk of at most
+// STEP_RATE_GOVERNOR_CHUNK_TICKS ticks, so other interrupts are served and no watchdog starves.
+static void st_benchmark_step_rate()
+{
+    uint8_t segment_count = SEGMENT_BUFFER_SIZE - 1;
+    uint16_t segment_ticks = STEP_RATE_GOVERNOR_TICKS / segment_count;
+    if (segment_ticks > STEP_RATE_GOVERNOR_CHUNK_TICKS)
     {
-        st.step_outbits &= sys.homing_axis_lock;
+        segment_ticks = STEP_RATE_GOVERNOR_CHUNK_TICKS;
+    }
+    if (segment_ticks == 0)
+    {
+        segment_ticks = 1;
     }
+    uint8_t idx, axis;
 
-    st.step_count--; // Decrement step events count
-    if (st.step_count == 0)
+    memset(&st, 0, sizeof(stepper_t));
+    memset(st_block_buffer, 0, sizeof(st_block_buffer));
+    memset(segment_buffer, 0, sizeof(segment_buffer));
+    for (idx = 0; idx < segment_count; idx++)
     {
-        // Segment is complete. Discard current segment and advance segment indexing.
-        st.exec_segment = NULL;
-        if ( ++segment_buffer_tail == SEGMENT_BUFFER_SIZE)
+        for (axis = 0; axis < N_AXIS; axis++)
         {
-            segment_buffer_tail = 0;
+            st_block_buffer[idx].steps[axis] = segment_ticks;
         }
+        st_block_buffer[idx].step_event_count = segment_ticks;
+        segment_buffer[idx].n_step = segment_ticks;
+        segment_buffer[idx].cycles_per_tick = 0xFFFF;
+        segment_buffer[idx].st_block_index = idx;
     }
-
-    st.step_outbits ^= step_port_invert_mask;  // Apply step port invert mask
-
-
-    // wait for step pulse time to complete...some of it should have expired during code above
-    while (esp_timer_get_time() < step_pulse_off_time)
+    st.exec_block_index = segment_count; // Forces the block initialization on the first segment.
+    segment_buffer_tail = 0;
+    segment_buffer_head = segment_count;
+
+    int32_t saved_position[N_AXIS];
+    memcpy(saved_position, sys_position, sizeof(sys_position));
+    uint8_t saved_state = sys.state;
+    sys.state = STATE_CYCLE;
+    gpio_out_map_t saved_step_pin_map[1 << N_AXIS];
+    gpio_out_map_t saved_dir_pin_map[1 << N_AXIS];
+    bool saved_step_pin_map_hi = step_pin_map_hi;
+    bool saved_dir_pin_map_hi = dir_pin_map_hi;
+    memcpy(saved_step_pin_map, step_pin_map, sizeof(step_pin_map));
+    memcpy(saved_dir_pin_map, dir_pin_map, sizeof(dir_pin_map));
+    memset(step_pin_map, 0, sizeof(step_pin_map));
+    memset(dir_pin_map, 0, sizeof(dir_pin_map));
+    step_pin_map_hi = true; // Writes both banks, like pins in the high bank would.
+    dir_pin_map_hi = true;
+
+    // One segment per chunk. A pulse reset interrupt the last tick of a chunk armed is served between
+    // the chunks, and only sets the pins as the direct call already did.
+    uint32_t tick_count = (uint32_t)segment_ticks * segment_count;
+    uint32_t cycles = 0;
+    for (idx = 0; idx < segment_count; idx++)
     {
-        NOP(); // spin here until time to turn off step
+        vTaskEnterCritical(&step_rate_benchmark_mutex);
+        uint32_t start_cycles = xthal_get_ccount();
+        for (uint16_t tick = 0; tick < segment_ticks; tick++)
+        {
+            onStepperDriverTimer((void *)STEP_TIMER_INDEX);
+#ifndef USE_RMT_STEPS
+            onStepperOffTimer((void *)STEP_OFF_TIMER_INDEX);
+#endif
+        }
+        cycles += xthal_get_ccount() - start_cycles;
+        vTaskExitCritical(&step_rate_benchmark_mutex);
+    }
+#ifdef USE_RMT_STEPS
+    for (axis = 0; axis < N_AXIS; axis++)
+    {
+        if (step_gpio[axis] >= 0)
+        {
+            RMT.conf_ch[step_rmt_channel[axis]].conf1.tx_start = 0; // No pulse once the channel is configured.
+        }
     }
-    set_stepper_pins_on(0); // turn all off
+#else
+    vTaskEnterCritical(&step_rate_benchmark_mutex);
+    timer_pause(STEP_TIMER_GROUP, STEP_OFF_TIMER_INDEX); // Armed by the last tick.
+    TIMERG0.int_clr_timers.t1 = 1;
+    vTaskExitCritical(&step_rate_benchmark_mutex);
+#endif
 
-    TIMERG0.hw_timer[STEP_TIMER_INDEX].config.alarm_en = TIMER_ALARM_EN;
+    sys.state = saved_state;
+    memcpy(step_pin_map, saved_step_pin_map, sizeof(step_pin_map));
+    memcpy(dir_pin_map, saved_dir_pin_map, sizeof(dir_pin_map));
+    step_pin_map_hi = saved_step_pin_map_hi;
+    dir_pin_map_hi = saved_dir_pin_map_hi;
+    memcpy(sys_position, saved_position, sizeof(sys_position));
+    memset(&st, 0, sizeof(stepper_t));
+    segment_buffer_tail = 0;
+    segment_buffer_head = 0;
+    segment_next_head = 1;
+    st_reset_underrun_stats();
+#ifdef STEPPER_ISR_PROFILER
+    st_reset_isr_profile();
+#endif
+#ifdef STEP_TRACE
+    st_reset_step_trace();
+#endif
 
-    busy = false;
+    float cycles_per_tick = (float)cycles / tick_count;
+#ifdef USE_RMT_STEPS
+    cycles_per_tick += STEP_RATE_GOVERNOR_ISR_ENTRY_CYCLES;
+#else
+    cycles_per_tick += 2 * STEP_RATE_GOVERNOR_ISR_ENTRY_CYCLES; // The driver and the pulse reset interrupt.
+#endif
+    if (cycles_per_tick < 1.0)
+    {
+        cycles_per_tick = 1.0;
+    }
+    st_max_step_rate = (ESP.getCpuFreqMHz() * 1000000.0 * STEP_RATE_GOVERNOR_LOAD_PERCENT / 100.0) / cycles_per_tick;
+#ifdef MAX_STEP_RATE_HZ
+    if (st_max_step_rate > MAX_STEP_RATE_HZ)
+    {
+        st_max_step_rate = MAX_STEP_RATE_HZ;
+    }
+#endif
 }
 
+float st_get_max_step_rate()
+{
+    return (st_max_step_rate);
+}
+#endif
 
 void stepper_init()
 {
 
-    // make the direction pins outputs
-#ifdef X_DIRECTION_PIN
-    pinMode(X_DIRECTION_PIN, OUTPUT);
-#endif
-#ifdef Y_DIRECTION_PIN
-    pinMode(Y_DIRECTION_PIN, OUTPUT);
-#endif
-
-    // make the step pins outputs
-#ifdef  X_STEP_PIN
-    pinMode(X_STEP_PIN, OUTPUT);
-#endif
-#ifdef Y_STEP_PIN
-    pinMode(Y_STEP_PIN, OUTPUT);
-#endif
+    // make the step and direction pins outputs
+    uint8_t axis;
+    for (axis = 0; axis < N_AXIS; axis++)
+    {
+        if (direction_gpio[axis] >= 0)
+        {
+            pinMode(direction_gpio[axis], OUTPUT);
+        }
+        if (step_gpio[axis] >= 0)
+        {
+            pinMode(step_gpio[axis], OUTPUT);
+        }
+    }
 
     // make the stepper disable pin an output
 #ifdef STEPPERS_DISABLE_PIN
@@ -356,10 +919,117 @@ void stepper_init()
     timer_init(STEP_TIMER_GROUP, STEP_TIMER_INDEX, &config);
     timer_set_counter_value(STEP_TIMER_GROUP, STEP_TIMER_INDEX, 0x00000000ULL);
     timer_enable_intr(STEP_TIMER_GROUP, STEP_TIMER_INDEX);
-    timer_isr_register(STEP_TIMER_GROUP, STEP_TIMER_INDEX, onStepperDriverTimer, 0, NULL, NULL);
+    timer_isr_register(STEP_TIMER_GROUP, STEP_TIMER_INDEX, onStepperDriverTimer, 0, 0, NULL);
+
+    // setup the step pulse reset timer. One-shot, armed by the stepper ISR on every step pulse.
+    config.divider     = STEPPER_OFF_TIMER_PRESCALE;
+    config.auto_reload = false;
+
+    timer_init(STEP_TIMER_GROUP, STEP_OFF_TIMER_INDEX, &config);
+    timer_set_counter_value(STEP_TIMER_GROUP, STEP_OFF_TIMER_INDEX, 0x00000000ULL);
+    timer_enable_intr(STEP_TIMER_GROUP, STEP_OFF_TIMER_INDEX);
+    timer_isr_register(STEP_TIMER_GROUP, STEP_OFF_TIMER_INDEX, onStepperOffTimer, 0, 0, NULL);
+
+#ifdef STEP_RATE_GOVERNOR
+    st_benchmark_step_rate(); // Before the RMT takes over the step pins.
+#endif
+
+#ifdef USE_RMT_STEPS
+    // Hand the step pins over to the RMT. One channel per axis, transmitting a single pulse per start.
+    rmt_config_t rmt_step_config;
+    memset(&rmt_step_config, 0, sizeof(rmt_config_t));
+    rmt_step_config.rmt_mode = RMT_MODE_TX;
+    rmt_step_config.clk_div = RMT_STEP_CLK_DIV;
+    rmt_step_config.mem_block_num = 1;
+    rmt_step_config.tx_config.loop_en = false;
+    rmt_step_config.tx_config.carrier_en = false;
+    rmt_step_config.tx_config.idle_output_en = true;
+    rmt_step_config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+    uint8_t idx;
+    for (idx = 0; idx < N_AXIS; idx++)
+    {
+        if (step_gpio[idx] >= 0)
+        {
+            rmt_step_config.channel = step_rmt_channel[idx];
+            rmt_step_config.gpio_num = (gpio_num_t)step_gpio[idx];
+            rmt_config(&rmt_step_config);
+        }
+    }
+    st_rmt_fill_step_items();
+#endif
+
+#ifdef USE_SEGMENT_PREP_TASK
+    segment_prep_mutex = xSemaphoreCreateRecursiveMutex();
+    xTaskCreatePinnedToCore(	segmentPrepTask,    // task
+                                "segmentPrepTask", // name for task
+                                4096,   // size of task stack
+                                NULL,   // parameters
+                                SEGMENT_PREP_TASK_PRIORITY, // priority
+                                &segmentPrepTaskHandle,
+                                SEGMENT_PREP_TASK_CORE // core
+                           );
+#endif
+}
 
+#ifdef USE_SEGMENT_PREP_TASK
+// Sleeps until the stepper ISR reports the segment buffer at the low-water mark, then refills it.
+// Uses the same state filter as the main loop's buffer reload in protocol_exec_rt_system().
+void segmentPrepTask(void *pvParameters)
+{
+    while (true) // run continuously
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_HOMING | STATE_SLEEP | STATE_JOG))
+        {
+            st_prep_buffer();
+        }
+    }
+}
+#endif
+
+void st_prep_lock()
+{
+#ifdef USE_SEGMENT_PREP_TASK
+    xSemaphoreTakeRecursive(segment_prep_mutex, portMAX_DELAY);
+#endif
+}
+
+void st_prep_unlock()
+{
+#ifdef USE_SEGMENT_PREP_TASK
+    xSemaphoreGiveRecursive(segment_prep_mutex);
+#endif
+}
 
+#ifdef USE_RMT_STEPS
+// Writes the step pulse into each RMT channel memory: the idle level for the STEP_PULSE_DELAY, then
+// the active level for $0 microseconds, followed by an end marker. Also sets the channel idle level,
+// so the step invert mask applies while not stepping. Called on wake up and on invert mask changes.
+void st_rmt_fill_step_items()
+{
+    rmt_item32_t rmt_step_items[2];
+    uint8_t idx;
+    for (idx = 0; idx < N_AXIS; idx++)
+    {
+        if (step_gpio[idx] < 0)
+        {
+            continue;
+        }
+        uint8_t idle_level = bit_istrue(step_port_invert_mask, bit(idx));
+#ifdef STEP_PULSE_DELAY
+        rmt_step_items[0].duration0 = STEP_PULSE_DELAY * RMT_STEP_TICKS_PER_MICROSECOND;
+#else
+        rmt_step_items[0].duration0 = 1; // Zero would end the transmission. One tick is 0.25usec.
+#endif
+        rmt_step_items[0].level0 = idle_level;
+        rmt_step_items[0].duration1 = settings.pulse_microseconds * RMT_STEP_TICKS_PER_MICROSECOND;
+        rmt_step_items[0].level1 = !idle_level;
+        rmt_step_items[1].val = 0; // End marker.
+        rmt_fill_tx_items(step_rmt_channel[idx], &rmt_step_items[0], 2, 0);
+        RMT.conf_ch[step_rmt_channel[idx]].conf1.idle_out_lv = idle_level;
+    }
 }
+#endif
 
 // enabled. Startup init and limits call this function but shouldn't start the cycle.
 void st_wake_up()
@@ -373,14 +1043,22 @@ void st_wake_up()
 
 
     // Initialize stepper output bits to ensure first ISR call does not step.
-    st.step_outbits = step_port_invert_mask;
+    st.step_outbits = 0;
+
+    // Start the buffer depth minimum of a new cycle, not of one resumed after a starvation. The ISR is
+    // stopped until Stepper_Timer_Start().
+    if (!segment_buffer_starved)
+    {
+        underrun_stats.cycle_min_depth = SEGMENT_BUFFER_SIZE - 1;
+    }
 
     // Initialize step pulse timing from settings. Here to ensure updating after re-writing.
-#ifdef STEP_PULSE_DELAY
-    // Step pulse delay handling is not require with ESP32...the RMT function does it.
+#ifdef USE_RMT_STEPS
+    // The RMT generates the pulse and the optional STEP_PULSE_DELAY from its channel memory.
+    st_rmt_fill_step_items();
 #else // Normal operation
-    // Set step pulse time. Ad hoc computation from oscilloscope. Uses two's complement.
-    st.step_pulse_time = -(((settings.pulse_microseconds - 2) * TICKS_PER_MICROSECOND) >> 3);
+    // Set step pulse time in stepper off timer ticks. The pulse is ended by onStepperOffTimer().
+    st.step_pulse_time = settings.pulse_microseconds * STEPPER_OFF_TICKS_PER_MICROSECOND;
 #endif
 
     // Enable Stepper Driver Interrupt
@@ -390,6 +1068,8 @@ void st_wake_up()
 // Reset and clear stepper subsystem variables
 void st_reset()
 {
+    st_prep_lock();
+
     // Initialize stepper driver idle state.
     st_go_idle();
 
@@ -401,42 +1081,120 @@ void st_reset()
     segment_buffer_tail = 0;
     segment_buffer_head = 0; // empty = tail
     segment_next_head = 1;
+    segment_buffer_starved = false;
+    segment_prep_exhausted = true;
+#ifdef STARTUP_CACHE
+    st_record.data = NULL;
+    if (st_replay.data)
+    {
+        st_replay.failed = true;
+        st_replay.data = NULL;
+    }
+#endif
+#ifdef CHECK_MODE_ESTIMATE
+    estimate_running = false;
+#endif
+    // NOTE: segment_stats are kept across resets. Cleared by st_reset_segment_stats().
     busy = false;
 
     st_generate_step_dir_invert_masks();
-    st.dir_outbits = dir_port_invert_mask; // Initialize direction bits to default.
+    st.dir_outbits = 0; // Initialize direction bits to default. Invert is applied by the pin map.
 
     // TODO do we need to turn step pins off?
 
+    st_prep_unlock();
 }
 
 
 
 
 
-void set_direction_pins_on(uint8_t onMask)
+// Sets the direction pins from a Grbl axis bitmask. Bit set means negative direction, before the
+// direction invert mask, which is folded into the precomputed pin map.
+void IRAM_ATTR set_direction_pins_on(uint8_t onMask)
 {
-    // inverts are applied in step generation
-#ifdef X_DIRECTION_PIN
-    digitalWrite(X_DIRECTION_PIN, (onMask & (1 << X_AXIS)));
-#endif
-#ifdef Y_DIRECTION_PIN
-    digitalWrite(Y_DIRECTION_PIN, (onMask & (1 << Y_AXIS)));
-#endif
+    const gpio_out_map_t *map = &dir_pin_map[onMask & ((1 << N_AXIS) - 1)];
+    GPIO.out_w1ts = map->set_lo;
+    GPIO.out_w1tc = map->clr_lo;
+    if (dir_pin_map_hi)
+    {
+        GPIO.out1_w1ts.val = map->set_hi;
+        GPIO.out1_w1tc.val = map->clr_hi;
+    }
 }
 
-void set_stepper_pins_on(uint8_t onMask)
+// Sets the step pins from a Grbl axis bitmask. Bit set means step pulse active, before the
+// step invert mask, which is folded into the precomputed pin map.
+void IRAM_ATTR set_stepper_pins_on(uint8_t onMask)
 {
-    onMask ^= settings.step_invert_mask; // invert pins as required by invert mask
-
-#ifdef X_STEP_PIN
-    digitalWrite(X_STEP_PIN, (onMask & (1 << X_AXIS)));
-#endif
-#ifdef Y_STEP_PIN
-    digitalWrite(Y_STEP_PIN, (onMask & (1 << Y_AXIS)));
+#ifdef USE_RMT_STEPS
+    // The step pins are routed to the RMT. Start a pulse on each stepping axis. The RMT ends the
+    // pulse and returns the pin to its idle level by itself, so there is nothing to clear.
+    uint8_t axis;
+    for (axis = 0; axis < N_AXIS; axis++)
+    {
+        if ((step_gpio[axis] >= 0) && (onMask & bit(axis)))
+        {
+            RMT.conf_ch[step_rmt_channel[axis]].conf1.mem_rd_rst = 1;
+            RMT.conf_ch[step_rmt_channel[axis]].conf1.tx_start = 1;
+        }
+    }
+#else
+    const gpio_out_map_t *map = &step_pin_map[onMask & ((1 << N_AXIS) - 1)];
+    GPIO.out_w1ts = map->set_lo;
+    GPIO.out_w1tc = map->clr_lo;
+    if (step_pin_map_hi)
+    {
+        GPIO.out1_w1ts.val = map->set_hi;
+        GPIO.out1_w1tc.val = map->clr_hi;
+    }
 #endif
 }
 
+// Builds the W1TS/W1TC register masks for every combination of axis bits. Pins not defined in
+// cpu_map.h are skipped, so Grbl virtually moves those axes as before.
+static bool st_build_pin_map(gpio_out_map_t *map, const int8_t *gpio, uint8_t invert_mask)
+{
+    bool uses_hi = false;
+    uint8_t bits, idx;
+    for (bits = 0; bits < (1 << N_AXIS); bits++)
+    {
+        memset(&map[bits], 0, sizeof(gpio_out_map_t));
+        for (idx = 0; idx < N_AXIS; idx++)
+        {
+            if (gpio[idx] < 0)
+            {
+                continue;
+            }
+            bool level = bit_istrue((bits ^ invert_mask), bit(idx));
+            if (gpio[idx] < 32)
+            {
+                if (level)
+                {
+                    map[bits].set_lo |= (1UL << gpio[idx]);
+                }
+                else
+                {
+                    map[bits].clr_lo |= (1UL << gpio[idx]);
+                }
+            }
+            else
+            {
+                uses_hi = true;
+                if (level)
+                {
+                    map[bits].set_hi |= (1UL << (gpio[idx] - 32));
+                }
+                else
+                {
+                    map[bits].clr_hi |= (1UL << (gpio[idx] - 32));
+                }
+            }
+        }
+    }
+    return (uses_hi);
+}
+
 
 // Stepper shutdown
 void st_go_idle()
@@ -445,6 +1203,11 @@ void st_go_idle()
     Stepper_Timer_Stop();
     busy = false;
 
+#ifdef SEGMENT_POSITION_ACCOUNTING
+    // Account for the steps of a segment interrupted mid-way, i.e. by homing, reset or alarm.
+    st_fold_segment_position();
+#endif
+
     bool pin_state = false;
     // Set stepper driver idle state, disabled or enabled, depending on settings and circumstances.
     if (((settings.stepper_idle_lock_time != 0xff) || sys_rt_exec_alarm || sys.state == STATE_SLEEP) && sys.state != STATE_HOMING)
@@ -472,42 +1235,412 @@ void st_go_idle()
 // Called by planner_recalculate() when the executing block is updated by the new plan.
 void st_update_plan_block_parameters()
 {
+    st_prep_lock();
     if (pl_block != NULL)   // Ignore if at start of a new block.
     {
-        prep.recalculate_flag |= PREP_FLAG_RECALCULATE;
-        pl_block->entry_speed_sqr = prep.current_speed * prep.current_speed; // Update entry speed.
-        pl_block = NULL; // Flag st_prep_segment() to load and check active velocity profile.
+        prep.recalculate_flag |= PREP_FLAG_RECALCULATE;
+        pl_block->entry_speed_sqr = prep.current_speed * prep.current_speed; // Update entry speed.
+        pl_block = NULL; // Flag st_prep_segment() to load and check active velocity profile.
+    }
+    st_prep_unlock();
+}
+
+
+// Generates the step and direction port invert masks used in the Stepper Interrupt Driver.
+void st_generate_step_dir_invert_masks()
+{
+    /*
+        uint8_t idx;
+        step_port_invert_mask = 0;
+        dir_port_invert_mask = 0;
+        for (idx=0; idx<N_AXIS; idx++) {
+        if (bit_istrue(settings.step_invert_mask,bit(idx))) { step_port_invert_mask |= get_step_pin_mask(idx); }
+        if (bit_istrue(settings.dir_invert_mask,bit(idx))) { dir_port_invert_mask |= get_direction_pin_mask(idx); }
+        }
+    */
+    // simpler with ESP32, but let's do it here for easier change management
+    step_port_invert_mask = settings.step_invert_mask;
+    dir_port_invert_mask = settings.dir_invert_mask;
+
+    // Rebuild the direct register pin maps with the new invert masks.
+    step_pin_map_hi = st_build_pin_map(step_pin_map, step_gpio, step_port_invert_mask);
+    dir_pin_map_hi = st_build_pin_map(dir_pin_map, direction_gpio, dir_port_invert_mask);
+#ifdef USE_RMT_STEPS
+    st_rmt_fill_step_items();
+#endif
+}
+
+// Increments the step segment buffer block data ring buffer.
+static uint8_t st_next_block_index(uint8_t block_index)
+{
+    block_index++;
+    if ( block_index == (SEGMENT_BUFFER_SIZE - 1) )
+    {
+        return (0);
+    }
+    return (block_index);
+}
+
+#ifdef JERK_LIMITED_ACCELERATION
+// Starts a ramp from the current speed to end_speed, between the given distances from the end of the
+// block. The profile computed by st_jerk_profile() gives the ramp at least the distance of a
+// jerk-limited speed change, so its acceleration, shaped into a trapezoid in time, rises at no more
+// than the block jerk limit to no more than the acceleration limit, holds, and falls back to zero.
+// The jerk phase time t_j solves jerk*t_j*(ramp_time-t_j) = |delta_speed|. Without a jerk limit, the
+// ramp is the planner's constant acceleration ramp.
+static void st_ramp_start(float mm_start, float mm_end, float end_speed)
+{
+    float delta_speed = end_speed - prep.current_speed;
+    float speed_sum = prep.current_speed + end_speed;
+    prep.ramp_elapsed = 0.0;
+    prep.ramp_time = 0.0;
+    if (speed_sum > 0.0)
+    {
+        prep.ramp_time = 2.0 * (mm_start - mm_end) / speed_sum;
+    }
+    prep.ramp_rise_end = 0.0;
+    prep.ramp_fall_start = prep.ramp_time;
+    prep.ramp_jerk = 0.0;
+    prep.ramp_accel = 0.0;
+    if (prep.ramp_time <= 0.0)
+    {
+        return; // Zero-length ramp. The caller snaps to the end speed.
+    }
+    if (pl_block->jerk <= 0.0)
+    {
+        prep.ramp_accel = delta_speed / prep.ramp_time;
+        return;
+    }
+    float jerk = pl_block->jerk;
+    float jerk_ratio = fabs(delta_speed) / (jerk * prep.ramp_time * prep.ramp_time);
+    if (jerk_ratio >= 0.25)
+    {
+        // Triangular acceleration. Only off the jerk limit by round-off.
+        prep.ramp_rise_end = 0.5 * prep.ramp_time;
+        jerk *= 4.0 * jerk_ratio;
+    }
+    else
+    {
+        prep.ramp_rise_end = 0.5 * prep.ramp_time * (1.0 - sqrt(1.0 - 4.0 * jerk_ratio));
+    }
+    prep.ramp_fall_start = prep.ramp_time - prep.ramp_rise_end;
+    prep.ramp_jerk = (delta_speed < 0.0) ? -jerk : jerk;
+}
+
+// Computes the jerk-out of the current ramp, which brings its acceleration down to zero at the jerk
+// limit, the quickest way to end it. Returns the distance it covers and sets *end_speed.
+static float st_ramp_jerk_out(float *end_speed)
+{
+    float time = fabs(prep.ramp_accel) / pl_block->jerk;
+    *end_speed = prep.current_speed + 0.5 * prep.ramp_accel * time;
+    return (time * (prep.current_speed + prep.ramp_accel * time / 3.0));
+}
+
+// Replaces the current ramp with its jerk-out, see st_ramp_jerk_out().
+static void st_ramp_start_jerk_out()
+{
+    prep.ramp_elapsed = 0.0;
+    prep.ramp_time = fabs(prep.ramp_accel) / pl_block->jerk;
+    prep.ramp_rise_end = 0.0;
+    prep.ramp_fall_start = 0.0;
+    prep.ramp_jerk = (prep.ramp_accel < 0.0) ? -pl_block->jerk : pl_block->jerk;
+}
+
+// Advances the current ramp by time_var, integrating each constant jerk phase exactly. Returns the
+// speed change and sets *mm_var to the distance traveled. Past the end of the ramp, the end speed is
+// held, so the segment generator detects the ramp end by distance just as it does for trapezoid ramps.
+static float st_ramp_advance(float time_var, float *mm_var)
+{
+    float speed = prep.current_speed;
+    float mm = 0.0;
+    while (time_var > 0.0)
+    {
+        float jerk = 0.0;
+        float phase_end = prep.ramp_time;
+        if (prep.ramp_elapsed < prep.ramp_rise_end)
+        {
+            jerk = prep.ramp_jerk;
+            phase_end = prep.ramp_rise_end;
+        }
+        else if (prep.ramp_elapsed < prep.ramp_fall_start)
+        {
+            phase_end = prep.ramp_fall_start;
+        }
+        else if (prep.ramp_elapsed < prep.ramp_time)
+        {
+            jerk = -prep.ramp_jerk;
+        }
+        else     // Past the end of the ramp.
+        {
+            prep.ramp_accel = 0.0;
+            prep.ramp_elapsed += time_var;
+            mm += time_var * speed;
+            break;
+        }
+        float dt = phase_end - prep.ramp_elapsed;
+        if (time_var < dt)
+        {
+            dt = time_var;
+            prep.ramp_elapsed += dt;
+        }
+        else
+        {
+            prep.ramp_elapsed = phase_end; // Lands exactly on the phase end despite round-off.
+        }
+        mm += dt * (speed + dt * (0.5 * prep.ramp_accel + dt * jerk / 6.0));
+        speed += dt * (prep.ramp_accel + 0.5 * jerk * dt);
+        prep.ramp_accel += jerk * dt;
+        time_var -= dt;
+    }
+    if (prep.ramp_elapsed >= prep.ramp_time)
+    {
+        prep.ramp_accel = 0.0;
+    }
+    *mm_var = mm;
+    return (speed - prep.current_speed);
+}
+
+// Starts the first ramp of a newly computed velocity profile, mm_start from the end of the block.
+// Later deceleration ramps are started at their ramp junctions in the segment loop.
+static void st_ramp_start_profile(float mm_start)
+{
+    if (prep.ramp_type == RAMP_DECEL)
+    {
+        st_ramp_start(mm_start, prep.mm_complete, prep.exit_speed);
+    }
+    else if (prep.ramp_type != RAMP_CRUISE)     // RAMP_ACCEL or RAMP_DECEL_OVERRIDE
+    {
+        st_ramp_start(mm_start, prep.accelerate_until, prep.maximum_speed);
+    }
+}
+
+// Computes the lowest speed the block decelerates to from speed within distance. Inverse of
+// plan_ramp_distance() for decelerations, like plan_ramp_speed() is for accelerations.
+static float st_ramp_lowest_speed(float speed, float distance)
+{
+    if (plan_ramp_distance(pl_block, speed, 0.0) <= distance)
+    {
+        return (0.0);
+    }
+    if (pl_block->jerk <= 0.0)
+    {
+        return (sqrt(speed * speed - 2 * pl_block->acceleration * distance));
+    }
+    float jerk_time = pl_block->acceleration / pl_block->jerk; // Time to reach the acceleration limit (min)
+    float jerk_speed = pl_block->acceleration * jerk_time; // Smallest speed change reaching the limit (mm/min)
+    float delta_speed;
+    if ((2.0 * speed >= 3.0 * jerk_speed) && (distance > (2.0 * speed - jerk_speed) * jerk_time))
+    {
+        // Reaches the acceleration limit. Solves the quadratic in the speed change for its smaller root,
+        // in the form that keeps its precision for small changes. Below 1.5 times jerk_speed, the
+        // triangular ramps already cover every distance the block decelerates over.
+        float b = 2.0 * speed - jerk_speed;
+        float c = 2.0 * (pl_block->acceleration * distance - speed * jerk_speed);
+        delta_speed = 2.0 * c / (b + sqrt(b * b - 4.0 * c));
+    }
+    else
+    {
+        // Triangular acceleration over the jerk phase time u: distance = 2*speed*u - jerk*u^3. Newton
+        // iterations from zero converge monotonically from below, so the ramp always fits.
+        float u = 0.0;
+        uint8_t iterations;
+        for (iterations = 0; iterations < 4; iterations++)
+        {
+            float u_sqr = u * u;
+            u -= (pl_block->jerk * u_sqr * u - 2.0 * speed * u + distance) / (3.0 * pl_block->jerk * u_sqr - 2.0 * speed);
+        }
+        delta_speed = pl_block->jerk * u * u;
+    }
+    return (speed - delta_speed);
+}
+
+// Jerk-limited counterpart of the velocity profile computation in st_fill_segment_buffer(), for blocks
+// with a jerk limit. Computes the profile from the current speed over the mm_remaining to the end of
+// the block, with ramps at least as long as plan_ramp_distance(). An exit speed out of reach is
+// lowered, and the next block then starts from it, as after a deceleration override. Only called with
+// no acceleration left over from the previous ramp, see st_ramp_defer_recalculation().
+static void st_jerk_profile(float mm_remaining)
+{
+    float entry_speed = prep.current_speed;
+    prep.mm_complete = 0.0;
+    prep.recalculate_flag &= ~(PREP_FLAG_RECALCULATE_AT_RAMP_END);
+    if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD)   // [Forced Deceleration to Zero Velocity]
+    {
+        prep.ramp_type = RAMP_DECEL;
+        float decel_dist = mm_remaining - plan_ramp_distance(pl_block, entry_speed, 0.0);
+        if (decel_dist < 0.0)
+        {
+            // Deceleration through entire planner block. End of feed hold is not in this block.
+            prep.exit_speed = st_ramp_lowest_speed(entry_speed, mm_remaining);
+        }
+        else
+        {
+            prep.mm_complete = decel_dist; // End of feed hold.
+            prep.exit_speed = 0.0;
+        }
+        return;
+    }
+
+    // [Normal Operation]
+    prep.ramp_type = RAMP_ACCEL;
+    prep.accelerate_until = mm_remaining;
+    if (sys.step_control & STEP_CONTROL_EXECUTE_SYS_MOTION)
+    {
+        prep.exit_speed = 0.0; // Enforce stop at end of system motion.
+    }
+    else
+    {
+        prep.exit_speed = sqrt(plan_get_exec_block_exit_speed_sqr());
+    }
+    float reach_speed = plan_ramp_speed(pl_block, entry_speed, mm_remaining);
+    if (prep.exit_speed >= reach_speed)
+    {
+        // Acceleration-only type. Entered below the planned speed after a deferred recalculation,
+        // the exit speed may be out of reach.
+        if (prep.exit_speed > reach_speed)
+        {
+            prep.exit_speed = reach_speed;
+            prep.recalculate_flag |= PREP_FLAG_DECEL_OVERRIDE;
+        }
+        prep.accelerate_until = 0.0;
+        prep.maximum_speed = prep.exit_speed;
+        return;
+    }
+
+    float nominal_speed = plan_compute_profile_nominal_speed(pl_block);
+    float decel_mm = plan_ramp_distance(pl_block, nominal_speed, prep.exit_speed);
+    float exit_mm = plan_ramp_distance(pl_block, entry_speed, prep.exit_speed);
+    if (entry_speed > nominal_speed)   // Only occurs during override reductions.
+    {
+        prep.accelerate_until = mm_remaining - plan_ramp_distance(pl_block, entry_speed, nominal_speed);
+        if (decel_mm <= prep.accelerate_until)
+        {
+            // Decelerate to cruise or cruise-decelerate types.
+            prep.decelerate_after = decel_mm;
+            prep.maximum_speed = nominal_speed;
+            prep.ramp_type = RAMP_DECEL_OVERRIDE;
+            return;
+        }
+        // No room to slow down to the nominal speed first. Decelerate over the whole block instead.
+        prep.ramp_type = RAMP_DECEL;
+    }
+    else if ((entry_speed >= prep.exit_speed) && (exit_mm >= mm_remaining))
+    {
+        prep.ramp_type = RAMP_DECEL; // Deceleration-only type
+    }
+    if (prep.ramp_type == RAMP_DECEL)
+    {
+        if ((entry_speed > prep.exit_speed) && (exit_mm > mm_remaining))
+        {
+            // Too fast to make the exit speed after an override reduction.
+            prep.exit_speed = st_ramp_lowest_speed(entry_speed, mm_remaining);
+            prep.recalculate_flag |= PREP_FLAG_DECEL_OVERRIDE;
+        }
+        return;
+    }
+
+    float accel_mm = plan_ramp_distance(pl_block, entry_speed, nominal_speed);
+    if ((accel_mm + decel_mm) < mm_remaining)   // Trapezoid type
+    {
+        prep.decelerate_after = decel_mm;
+        prep.maximum_speed = nominal_speed;
+        if (entry_speed == nominal_speed)
+        {
+            // Cruise-deceleration or cruise-only type.
+            prep.ramp_type = RAMP_CRUISE;
+        }
+        else
+        {
+            // Full-trapezoid or acceleration-cruise types
+            prep.accelerate_until -= accel_mm;
+        }
+        return;
+    }
+
+    // Triangle type. When both ramps reach the acceleration limit, their distances add up to a quadratic
+    // in the peak speed. Otherwise, bisects for the highest peak speed that still fits the block, to
+    // 1/256 of the speed range, which costs at most that much of the peak.
+    float low = MAX(entry_speed, prep.exit_speed);
+    float high = nominal_speed;
+    float jerk_time = pl_block->acceleration / pl_block->jerk;
+    float jerk_speed = pl_block->acceleration * jerk_time;
+    float c = 0.5 * jerk_time * (entry_speed + prep.exit_speed)
+              - (entry_speed * entry_speed + prep.exit_speed * prep.exit_speed) / (2.0 * pl_block->acceleration)
+              - mm_remaining;
+    float peak_speed = pl_block->acceleration * (sqrt(jerk_time * jerk_time - 4.0 * c / pl_block->acceleration) - jerk_time) / 2.0;
+    if ((peak_speed - low >= jerk_speed) && (peak_speed <= high))
+    {
+        high = peak_speed;
+        if ((plan_ramp_distance(pl_block, entry_speed, high) + plan_ramp_distance(pl_block, high, prep.exit_speed)) <= mm_remaining)
+        {
+            low = high;
+        }
+    }
+    uint8_t iterations;
+    for (iterations = 0; (iterations < 8) && (low < high); iterations++)
+    {
+        float mid = 0.5 * (low + high);
+        if ((plan_ramp_distance(pl_block, entry_speed, mid) + plan_ramp_distance(pl_block, mid, prep.exit_speed)) > mm_remaining)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid;
+        }
     }
+    prep.accelerate_until -= plan_ramp_distance(pl_block, entry_speed, low);
+    prep.decelerate_after = prep.accelerate_until;
+    prep.maximum_speed = low;
 }
 
-
-// Generates the step and direction port invert masks used in the Stepper Interrupt Driver.
-void st_generate_step_dir_invert_masks()
+// Called on a recalculation of the prepped block. Recomputing the profile in the middle of a shaped
+// ramp would drop its acceleration to zero at once. Instead, the ramp is ended with a jerk-out, and
+// the recalculation follows at its end. That only ever takes less distance than the acceleration
+// ramp it replaces. A deceleration ramp is only cut short for a higher exit speed it still makes
+// after the jerk-out, and otherwise runs on to its end. Returns true if the recalculation is deferred.
+static bool st_ramp_defer_recalculation()
 {
-    /*
-        uint8_t idx;
-        step_port_invert_mask = 0;
-        dir_port_invert_mask = 0;
-        for (idx=0; idx<N_AXIS; idx++) {
-        if (bit_istrue(settings.step_invert_mask,bit(idx))) { step_port_invert_mask |= get_step_pin_mask(idx); }
-        if (bit_istrue(settings.dir_invert_mask,bit(idx))) { dir_port_invert_mask |= get_direction_pin_mask(idx); }
+    if ((pl_block->jerk <= 0.0) || (prep.ramp_type == RAMP_CRUISE) || (prep.ramp_accel == 0.0))
+    {
+        return (false);
+    }
+    float end_speed = (prep.ramp_type == RAMP_DECEL) ? prep.exit_speed : prep.maximum_speed;
+    if (prep.current_speed == end_speed)
+    {
+        return (false); // Ramp already snapped to its end.
+    }
+    float jerk_out_speed;
+    float jerk_out_mm = st_ramp_jerk_out(&jerk_out_speed);
+    bool jerk_out = (prep.ramp_accel > 0.0);
+    if ((prep.ramp_type == RAMP_DECEL) && !(sys.step_control & STEP_CONTROL_EXECUTE_HOLD))
+    {
+        float exit_speed = 0.0;
+        if (!(sys.step_control & STEP_CONTROL_EXECUTE_SYS_MOTION))
+        {
+            exit_speed = sqrt(plan_get_exec_block_exit_speed_sqr());
         }
-    */
-    // simpler with ESP32, but let's do it here for easier change management
-    step_port_invert_mask = settings.step_invert_mask;
-    dir_port_invert_mask = settings.dir_invert_mask;
-}
-
-// Increments the step segment buffer block data ring buffer.
-static uint8_t st_next_block_index(uint8_t block_index)
-{
-    block_index++;
-    if ( block_index == (SEGMENT_BUFFER_SIZE - 1) )
+        float mm_remaining = pl_block->millimeters - jerk_out_mm;
+        jerk_out = (exit_speed > prep.exit_speed) && (mm_remaining >= 0.0)
+                   && (plan_ramp_distance(pl_block, jerk_out_speed, MIN(exit_speed, jerk_out_speed)) <= mm_remaining);
+    }
+    prep.recalculate_flag |= PREP_FLAG_RECALCULATE_AT_RAMP_END;
+    if (jerk_out)
     {
-        return (0);
+        prep.ramp_type = (prep.ramp_accel > 0.0) ? RAMP_ACCEL : RAMP_DECEL_OVERRIDE;
+        prep.maximum_speed = jerk_out_speed;
+        prep.accelerate_until = MAX(pl_block->millimeters - jerk_out_mm, 0.0);
+        prep.decelerate_after = 0.0;
+        st_ramp_start_jerk_out();
     }
-    return (block_index);
+    else if (prep.ramp_type == RAMP_DECEL)
+    {
+        // Ends at the end of the block or of a feed hold, and the next block starts from its end speed.
+        prep.recalculate_flag |= PREP_FLAG_DECEL_OVERRIDE;
+    }
+    return (true);
 }
+#endif
 
 /*  Prepares step segment buffer. Continuously called from main program.
 
@@ -521,8 +1654,45 @@ static uint8_t st_next_block_index(uint8_t block_index)
     longer than the time it takes the stepper algorithm to empty it before refilling it.
     Currently, the segment buffer conservatively holds roughly up to 40-50 msec of steps.
     NOTE: Computation units are in steps, millimeters, and minutes.
+    NOTE: With JERK_LIMITED_ACCELERATION, blocks with a jerk limit get their velocity profile from
+    st_jerk_profile(), and its ramps are traced on a jerk-limited velocity curve, see st_ramp_advance().
+    Cruising is unchanged.
+    NOTE: With USE_SEGMENT_PREP_TASK, this is also run by the segment prep task whenever the stepper
+    ISR drains the buffer to SEGMENT_BUFFER_LOW_WATER, so the buffer no longer depends on how often
+    the main program gets back to it.
 */
 void st_prep_buffer()
+{
+    st_prep_lock();
+    st_fill_segment_buffer();
+    segment_prep_exhausted = st_segment_prep_exhausted();
+    st_resume_starved_cycle();
+    st_prep_unlock();
+}
+
+// Restarts the stepper ISR after it stopped on a starved segment buffer, once segments are queued again.
+// Ends the cycle the ISR held open instead, if the motion turned out to be complete, like when a feed
+// hold ended it without another segment.
+static void st_resume_starved_cycle()
+{
+    if (!segment_buffer_starved)
+    {
+        return;
+    }
+    if (segment_index_load(segment_buffer_head) != segment_index_load(segment_buffer_tail))
+    {
+        st_wake_up();
+        segment_buffer_starved = false;
+    }
+    else if (st_segment_prep_exhausted())
+    {
+        segment_buffer_starved = false;
+        st_go_idle();
+        system_set_exec_state_flag(EXEC_CYCLE_STOP);
+    }
+}
+
+static void st_fill_segment_buffer()
 {
     // Block step prep buffer, while in a suspend state and there is no suspend motion to execute.
     if (bit_istrue(sys.step_control, STEP_CONTROL_END_MOTION))
@@ -530,7 +1700,19 @@ void st_prep_buffer()
         return;
     }
 
-    while (segment_buffer_tail != segment_next_head)   // Check if we need to fill the buffer.
+#ifdef STARTUP_CACHE
+    if (st_replay.data)
+    {
+        st_replay_segments();
+        if (st_replay.data)
+        {
+            return;
+        }
+        // A feed hold may have handed the rest of the recording to the planner.
+    }
+#endif
+
+    while (segment_index_load(segment_buffer_tail) != segment_next_head)   // Check if we need to fill the buffer.
     {
 
         // Determine if we need to load a new planner block or if the block needs to be recomputed.
@@ -556,6 +1738,12 @@ void st_prep_buffer()
             {
 
                 prep.recalculate_flag = false;
+#ifdef JERK_LIMITED_ACCELERATION
+                if (st_ramp_defer_recalculation())
+                {
+                    continue; // Keep prepping the current ramp.
+                }
+#endif
 
             }
             else
@@ -586,12 +1774,22 @@ void st_prep_buffer()
                 }
                 st_prep_block->step_event_count = pl_block->step_event_count << MAX_AMASS_LEVEL;
 #endif
+#ifdef STARTUP_CACHE
+                if (st_record.data)
+                {
+                    st_record_block();
+                }
+#endif
 
                 // Initialize segment buffer data for generating the segments.
                 prep.steps_remaining = (float)pl_block->step_event_count;
                 prep.step_per_mm = prep.steps_remaining / pl_block->millimeters;
                 prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR / prep.step_per_mm;
                 prep.dt_remainder = 0.0; // Reset for new segment block
+                prep.block_segments = 0;
+#ifdef JERK_LIMITED_ACCELERATION
+                prep.recalculate_flag &= ~(PREP_FLAG_RECALCULATE_AT_RAMP_END); // Ended with the last block.
+#endif
 
                 if ((sys.step_control & STEP_CONTROL_EXECUTE_HOLD) || (prep.recalculate_flag & PREP_FLAG_DECEL_OVERRIDE))
                 {
@@ -615,6 +1813,13 @@ void st_prep_buffer()
             */
             prep.mm_complete = 0.0; // Default velocity profile complete at 0.0mm from end of block.
             float inv_2_accel = 0.5 / pl_block->acceleration;
+#ifdef JERK_LIMITED_ACCELERATION
+            if (pl_block->jerk > 0.0)
+            {
+                st_jerk_profile(pl_block->millimeters);
+            }
+            else
+#endif
             if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD)   // [Forced Deceleration to Zero Velocity]
             {
                 // Compute velocity profile parameters for a feed hold in-progress. This profile overrides
@@ -723,6 +1928,10 @@ void st_prep_buffer()
                 }
             }
 
+#ifdef JERK_LIMITED_ACCELERATION
+            st_ramp_start_profile(pl_block->millimeters);
+#endif
+
         }
 
         // Initialize new segment
@@ -745,7 +1954,12 @@ void st_prep_buffer()
             the end of planner block (typical) or mid-block at the end of a forced deceleration,
             such as from a feed hold.
         */
+#ifdef ADAPTIVE_SEGMENT_DURATION
+        // Short segments on ramps to trace the speed changes, long ones for cruising.
+        float dt_max = (prep.ramp_type == RAMP_CRUISE) ? DT_SEGMENT_CRUISE : DT_SEGMENT_RAMP; // Maximum segment time
+#else
         float dt_max = DT_SEGMENT; // Maximum segment time
+#endif
         float dt = 0.0; // Initialize segment time
         float time_var = dt_max; // Time worker variable
         float mm_var; // mm-Distance worker variable
@@ -762,16 +1976,33 @@ void st_prep_buffer()
             switch (prep.ramp_type)
             {
                 case RAMP_DECEL_OVERRIDE:
+#ifdef JERK_LIMITED_ACCELERATION
+                    speed_var = -st_ramp_advance(time_var, &mm_var);
+#else
                     speed_var = pl_block->acceleration * time_var;
                     mm_var = time_var * (prep.current_speed - 0.5 * speed_var);
+#endif
                     mm_remaining -= mm_var;
                     if ((mm_remaining < prep.accelerate_until) || (mm_var <= 0))
                     {
                         // Cruise or cruise-deceleration types only for deceleration override.
+#ifdef JERK_LIMITED_ACCELERATION
+                        // Time from the start of this pass, which need not be the first of the segment.
+                        time_var = 2.0 * (mm_remaining + mm_var - prep.accelerate_until) / (prep.current_speed + prep.maximum_speed);
+                        mm_remaining = prep.accelerate_until; // NOTE: 0.0 at EOB
+#else
                         mm_remaining = prep.accelerate_until; // NOTE: 0.0 at EOB
                         time_var = 2.0 * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
+#endif
                         prep.ramp_type = RAMP_CRUISE;
                         prep.current_speed = prep.maximum_speed;
+#ifdef JERK_LIMITED_ACCELERATION
+                        if (prep.recalculate_flag & PREP_FLAG_RECALCULATE_AT_RAMP_END)
+                        {
+                            st_jerk_profile(mm_remaining);
+                            st_ramp_start_profile(mm_remaining);
+                        }
+#endif
                     }
                     else     // Mid-deceleration override ramp.
                     {
@@ -780,13 +2011,24 @@ void st_prep_buffer()
                     break;
                 case RAMP_ACCEL:
                     // NOTE: Acceleration ramp only computes during first do-while loop.
+#ifdef JERK_LIMITED_ACCELERATION
+                    speed_var = st_ramp_advance(time_var, &mm_var);
+                    mm_remaining -= mm_var;
+#else
                     speed_var = pl_block->acceleration * time_var;
                     mm_remaining -= time_var * (prep.current_speed + 0.5 * speed_var);
+#endif
                     if (mm_remaining < prep.accelerate_until)   // End of acceleration ramp.
                     {
                         // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
+#ifdef JERK_LIMITED_ACCELERATION
+                        // Time from the start of this pass, which need not be the first of the segment.
+                        time_var = 2.0 * (mm_remaining + mm_var - prep.accelerate_until) / (prep.current_speed + prep.maximum_speed);
+                        mm_remaining = prep.accelerate_until; // NOTE: 0.0 at EOB
+#else
                         mm_remaining = prep.accelerate_until; // NOTE: 0.0 at EOB
                         time_var = 2.0 * (pl_block->millimeters - mm_remaining) / (prep.current_speed + prep.maximum_speed);
+#endif
                         if (mm_remaining == prep.decelerate_after)
                         {
                             prep.ramp_type = RAMP_DECEL;
@@ -796,6 +2038,17 @@ void st_prep_buffer()
                             prep.ramp_type = RAMP_CRUISE;
                         }
                         prep.current_speed = prep.maximum_speed;
+#ifdef JERK_LIMITED_ACCELERATION
+                        if (prep.recalculate_flag & PREP_FLAG_RECALCULATE_AT_RAMP_END)
+                        {
+                            st_jerk_profile(mm_remaining);
+                            st_ramp_start_profile(mm_remaining);
+                        }
+                        else if (prep.ramp_type == RAMP_DECEL)
+                        {
+                            st_ramp_start(mm_remaining, prep.mm_complete, prep.exit_speed);
+                        }
+#endif
                     }
                     else     // Acceleration only.
                     {
@@ -813,6 +2066,13 @@ void st_prep_buffer()
                         time_var = (mm_remaining - prep.decelerate_after) / prep.maximum_speed;
                         mm_remaining = prep.decelerate_after; // NOTE: 0.0 at EOB
                         prep.ramp_type = RAMP_DECEL;
+#ifdef ADAPTIVE_SEGMENT_DURATION
+                        // Shorten a long cruise segment to a ramp segment, or end it at the junction.
+                        dt_max = MAX(dt + time_var, DT_SEGMENT_RAMP);
+#endif
+#ifdef JERK_LIMITED_ACCELERATION
+                        st_ramp_start(mm_remaining, prep.mm_complete, prep.exit_speed);
+#endif
                     }
                     else     // Cruising only.
                     {
@@ -821,11 +2081,24 @@ void st_prep_buffer()
                     break;
                 default: // case RAMP_DECEL:
                     // NOTE: mm_var used as a misc worker variable to prevent errors when near zero speed.
+#ifdef JERK_LIMITED_ACCELERATION
+                    speed_var = -st_ramp_advance(time_var, &mm_var); // Used as delta speed (mm/min)
+                    mm_var = mm_remaining - mm_var; // Distance from end of segment to end of block (mm)
+#else
                     speed_var = pl_block->acceleration * time_var; // Used as delta speed (mm/min)
+#endif
+#ifdef JERK_LIMITED_ACCELERATION
+                    // The shaped ramp flattens out into its end speed, so detect its end by time. Checking
+                    // the speed alone leaves a residual distance that is never covered.
+                    if ((prep.current_speed > speed_var) && (prep.ramp_elapsed < prep.ramp_time))
+#else
                     if (prep.current_speed > speed_var)   // Check if at or below zero speed.
+#endif
                     {
+#ifndef JERK_LIMITED_ACCELERATION
                         // Compute distance from end of segment to end of block.
                         mm_var = mm_remaining - time_var * (prep.current_speed - 0.5 * speed_var); // (mm)
+#endif
                         if (mm_var > prep.mm_complete)   // Typical case. In deceleration ramp.
                         {
                             mm_remaining = mm_var;
@@ -960,8 +2233,21 @@ void st_prep_buffer()
         }
 #endif
 
+#ifdef CHECK_MODE_ESTIMATE
+        if (estimate_running)
+        {
+            st_estimate_segment(prep_segment, inv_rate);
+        }
+#endif
+
         // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
-        segment_buffer_head = segment_next_head;
+        segment_index_store(segment_buffer_head, segment_next_head);
+        uint8_t segments_queued = st_segment_buffer_count(segment_next_head, segment_index_load(segment_buffer_tail));
+        if (segments_queued > segment_stats.buffer_high_water)
+        {
+            segment_stats.buffer_high_water = segments_queued;
+        }
+        prep.block_segments++;
         if ( ++segment_next_head == SEGMENT_BUFFER_SIZE )
         {
             segment_next_head = 0;
@@ -971,6 +2257,12 @@ void st_prep_buffer()
         pl_block->millimeters = mm_remaining;
         prep.steps_remaining = n_steps_remaining;
         prep.dt_remainder = (n_steps_remaining - step_dist_remaining) * inv_rate;
+#ifdef STARTUP_CACHE
+        if (st_record.data)
+        {
+            st_record_segment(prep_segment);
+        }
+#endif
 
         // Check for exit conditions and flag to load next planner block.
         if (mm_remaining == prep.mm_complete)
@@ -994,13 +2286,336 @@ void st_prep_buffer()
                 }
                 pl_block = NULL; // Set pointer to indicate check and load next planner block.
                 plan_discard_current_block();
+                segment_stats.block_count++;
+#ifdef CHECK_MODE_ESTIMATE
+                if (estimate_running)
+                {
+                    estimate.block_count++;
+                }
+#endif
+                segment_stats.segment_count += prep.block_segments;
+                segment_stats.last_block_segments = prep.block_segments;
+                if (prep.block_segments > segment_stats.max_block_segments)
+                {
+                    segment_stats.max_block_segments = prep.block_segments;
+                }
+            }
+        }
+
+    }
+}
+
+
+
+#ifdef STARTUP_CACHE
+// Appends an entry of two parts to the recording. Fails the recording when it is full.
+static void st_record_entry(uint8_t tag, const void *data, uint32_t size, const void *extra, uint32_t extra_size)
+{
+    if (st_record.failed || (st_record.position + 1 + size + extra_size > st_record.size))
+    {
+        st_record.failed = true;
+        return;
+    }
+    st_record.data[st_record.position++] = tag;
+    memcpy(&st_record.data[st_record.position], data, size);
+    st_record.position += size;
+    memcpy(&st_record.data[st_record.position], extra, extra_size);
+    st_record.position += extra_size;
+}
+
+// Records a newly loaded block, with the planner block it was loaded from. Called by
+// st_fill_segment_buffer(), before any of the block's distance is prepped.
+static void st_record_block()
+{
+    st_record_entry(ST_STREAM_BLOCK, st_prep_block, sizeof(st_block_t), pl_block, sizeof(plan_block_t));
+}
+
+// Records a segment handed to the stepper ISR, with the segment generator state after it. A feed hold
+// changes the motion, so the recording fails. Called by st_fill_segment_buffer().
+static void st_record_segment(segment_t *segment)
+{
+    if (sys.step_control & (STEP_CONTROL_EXECUTE_HOLD | STEP_CONTROL_EXECUTE_SYS_MOTION))
+    {
+        st_record.failed = true;
+    }
+    st_stream_prep_t state;
+    state.mm_remaining = pl_block->millimeters;
+    state.steps_remaining = prep.steps_remaining;
+    state.dt_remainder = prep.dt_remainder;
+    state.current_speed = prep.current_speed;
+    st_record_entry(ST_STREAM_SEGMENT, segment, sizeof(segment_t), &state, sizeof(state));
+}
+
+// Hands the rest of the replay to the planner and the segment generator, when a feed hold interrupts
+// it. The recorded planner blocks from the one being replayed onward are buffered, the first one cut
+// to its remaining distance, which the segment generator continues as a partially completed block.
+// So the hold decelerates like it does for planned motion, and a cycle start completes the motion.
+// Blocks that do not fit into the planner buffer are dropped. Called by st_replay_segments().
+static void st_replay_handoff()
+{
+    plan_block_t block;
+    prep.recalculate_flag = false;
+    prep.current_speed = 0.0;
+    if (st_replay.block_position)
+    {
+        memcpy(&block, &st_replay.data[st_replay.block_position], sizeof(plan_block_t));
+        prep.current_speed = st_replay.prep.current_speed;
+        if (st_replay.prep.mm_remaining > 0.0)
+        {
+            prep.step_per_mm = (float)block.step_event_count / block.millimeters;
+            prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR / prep.step_per_mm;
+            prep.steps_remaining = st_replay.prep.steps_remaining;
+            prep.dt_remainder = st_replay.prep.dt_remainder;
+            prep.recalculate_flag = PREP_FLAG_RECALCULATE; // Keeps the block's Bresenham data.
+            st_prep_block = &st_block_buffer[prep.st_block_index];
+            block.millimeters = st_replay.prep.mm_remaining;
+            block.entry_speed_sqr = prep.current_speed * prep.current_speed;
+            plan_buffer_block(&block);
+        }
+    }
+    prep.exit_speed = prep.current_speed; // Entry speed of the next block loaded during the hold.
+
+    uint32_t position = st_replay.position;
+    while (position < st_replay.size)
+    {
+        if (st_replay.data[position++] == ST_STREAM_BLOCK)
+        {
+            memcpy(&block, &st_replay.data[position + sizeof(st_block_t)], sizeof(plan_block_t));
+            if (!plan_buffer_block(&block))
+            {
+                st_replay.failed = true;
+                break;
+            }
+            position += ST_STREAM_BLOCK_SIZE;
+        }
+        else
+        {
+            position += ST_STREAM_SEGMENT_SIZE;
+        }
+    }
+    st_replay.data = NULL;
+    plan_cycle_reinitialize(); // Plans the buffered blocks to a stop, from the current block on.
+}
+
+// Hands recorded segments to the stepper ISR, until the segment buffer is full or the recording ends.
+// A feed hold ends the replay, see st_replay_handoff().
+static void st_replay_segments()
+{
+    while (segment_index_load(segment_buffer_tail) != segment_next_head)
+    {
+        if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD)
+        {
+            st_replay_handoff();
+            return;
+        }
+        if (st_replay.position >= st_replay.size)
+        {
+            st_replay.data = NULL; // Done. Planner blocks queued after the startup blocks follow normally.
+            return;
+        }
+
+        uint8_t tag = st_replay.data[st_replay.position++];
+        if (tag == ST_STREAM_BLOCK)
+        {
+            prep.st_block_index = st_next_block_index(prep.st_block_index);
+            memcpy(&st_block_buffer[prep.st_block_index], &st_replay.data[st_replay.position], sizeof(st_block_t));
+            st_replay.block_position = st_replay.position + sizeof(st_block_t);
+            st_replay.position += ST_STREAM_BLOCK_SIZE;
+        }
+        else
+        {
+            segment_t *replay_segment = &segment_buffer[segment_buffer_head];
+            memcpy(replay_segment, &st_replay.data[st_replay.position], sizeof(segment_t));
+            memcpy(&st_replay.prep, &st_replay.data[st_replay.position + sizeof(segment_t)], sizeof(st_stream_prep_t));
+            st_replay.position += ST_STREAM_SEGMENT_SIZE;
+            replay_segment->st_block_index = prep.st_block_index;
+
+            segment_index_store(segment_buffer_head, segment_next_head);
+            if ( ++segment_next_head == SEGMENT_BUFFER_SIZE )
+            {
+                segment_next_head = 0;
+            }
+        }
+    }
+}
+
+void st_record_start(uint8_t *buffer, uint32_t size)
+{
+    st_prep_lock();
+    st_record.data = buffer;
+    st_record.size = size;
+    st_record.position = 0;
+    st_record.failed = false;
+    st_prep_unlock();
+}
+
+uint32_t st_record_stop()
+{
+    st_prep_lock();
+    uint32_t size = ((st_record.data && !st_record.failed) ? st_record.position : 0);
+    st_record.data = NULL;
+    st_prep_unlock();
+    return (size);
+}
+
+void st_record_abort()
+{
+    st_prep_lock();
+    st_record.failed = true;
+    st_prep_unlock();
+}
+
+// Checks the stream, before any of it is executed. Every entry must be complete, every segment must
+// follow a block, and no segment may step faster than the step rate governor allows.
+bool st_replay_start(const uint8_t *stream, uint32_t size)
+{
+    uint32_t position = 0;
+    bool have_block = false;
+    while (position < size)
+    {
+        uint8_t tag = stream[position++];
+        if ((tag == ST_STREAM_BLOCK) && (position + ST_STREAM_BLOCK_SIZE <= size))
+        {
+            position += ST_STREAM_BLOCK_SIZE;
+            have_block = true;
+        }
+        else if ((tag == ST_STREAM_SEGMENT) && (position + ST_STREAM_SEGMENT_SIZE <= size) && have_block)
+        {
+            segment_t segment;
+            memcpy(&segment, &stream[position], sizeof(segment_t));
+            position += ST_STREAM_SEGMENT_SIZE;
+#ifdef STEP_RATE_GOVERNOR
+            if ((segment.cycles_per_tick == 0) || ((float)F_STEPPER_TIMER / segment.cycles_per_tick > st_get_max_step_rate()))
+            {
+                return (false);
             }
+#endif
+        }
+        else
+        {
+            return (false);
+        }
+    }
+
+    st_prep_lock();
+    st_replay.data = (uint8_t *)stream;
+    st_replay.size = size;
+    st_replay.position = 0;
+    st_replay.failed = false;
+    st_replay.block_position = 0;
+    st_prep_unlock();
+    return (true);
+}
+
+bool st_replay_stop()
+{
+    st_prep_lock();
+    bool completed = (st_replay.data == NULL) && !st_replay.failed;
+    if (st_replay.data)
+    {
+        st_replay.failed = true;
+        st_replay.data = NULL;
+    }
+    st_prep_unlock();
+    return (completed);
+}
+#endif
+
+#ifdef CHECK_MODE_ESTIMATE
+// Adds a segment to the run time estimate. The stepper ISR executes n_step ticks of cycles_per_tick
+// stepper timer ticks each. inv_rate is the segment time per step event in minutes. Called by
+// st_fill_segment_buffer(), while pl_block is the block of the segment.
+static void st_estimate_segment(const segment_t *segment, float inv_rate)
+{
+    estimate.motion_ticks += (uint64_t)segment->n_step * segment->cycles_per_tick;
+    float event_rate = 1.0 / inv_rate; // (step events/min)
+    float rate = event_rate / prep.step_per_mm;
+    if (rate > estimate.peak_rate)
+    {
+        estimate.peak_rate = rate;
+    }
+    uint8_t idx;
+    for (idx = 0; idx < N_AXIS; idx++)
+    {
+        float axis_rate = event_rate * settings_derived.mm_per_step[idx] * pl_block->steps[idx] / pl_block->step_event_count;
+        if (axis_rate > estimate.peak_axis_rate[idx])
+        {
+            estimate.peak_axis_rate[idx] = axis_rate;
         }
+    }
+}
 
+void st_estimate_start()
+{
+    st_prep_lock();
+    memset(&estimate, 0, sizeof(st_estimate_t));
+    estimate_running = true;
+    st_prep_unlock();
+}
+
+bool st_estimate_running()
+{
+    return (estimate_running);
+}
+
+void st_estimate_execute(bool synchronize)
+{
+    st_prep_lock();
+    do
+    {
+        st_fill_segment_buffer();
+        // Hand the segments straight back. Their timing was added up when they were generated.
+        segment_index_store(segment_buffer_tail, segment_index_load(segment_buffer_head));
     }
+    while (synchronize ? !st_segment_prep_exhausted() : plan_check_full_buffer());
+    st_prep_unlock();
+}
+
+void st_estimate_dwell(float seconds)
+{
+    estimate.dwell_time += seconds;
+}
+
+void st_get_estimate(st_estimate_t *estimate_copy)
+{
+    st_prep_lock();
+    memcpy(estimate_copy, &estimate, sizeof(st_estimate_t));
+    st_prep_unlock();
+}
+#endif
+
+// Returns the segment generator statistics. Reported and cleared with the ISR profile ($P / $PR).
+void st_get_segment_stats(st_segment_stats_t *stats)
+{
+    st_prep_lock();
+    memcpy(stats, &segment_stats, sizeof(st_segment_stats_t));
+    st_prep_unlock();
+}
+
+void st_reset_segment_stats()
+{
+    st_prep_lock();
+    memset(&segment_stats, 0, sizeof(st_segment_stats_t));
+    st_prep_unlock();
 }
 
+// NOTE: Like the ISR profile, the critical section masks the stepper ISR, the only writer.
+void st_get_underrun_stats(st_underrun_stats_t *stats)
+{
+    vTaskEnterCritical(&underrun_stats_mutex);
+    memcpy(stats, &underrun_stats, sizeof(st_underrun_stats_t));
+    vTaskExitCritical(&underrun_stats_mutex);
+}
 
+void st_reset_underrun_stats()
+{
+    vTaskEnterCritical(&underrun_stats_mutex);
+    underrun_stats.stop_count = 0;
+    underrun_stats.starvation_count = 0;
+    underrun_stats.cycle_min_depth = SEGMENT_BUFFER_SIZE - 1;
+    underrun_stats.min_depth = SEGMENT_BUFFER_SIZE - 1;
+    vTaskExitCritical(&underrun_stats_mutex);
+}
 
 // Called by realtime status reporting to fetch the current speed being executed. This value
 // however is not exactly the current speed, but the speed computed in the last step segment
@@ -1015,6 +2630,51 @@ float st_get_realtime_rate()
     return 0.0f;
 }
 
+#ifdef STEPPER_ISR_PROFILER
+// NOTE: The stepper ISR is registered from setup() and runs on the same core as the main program.
+// Entering the critical section masks it, so the statistics are copied or cleared consistently
+// without the ISR having to take a lock on every tick.
+void st_get_isr_profile(st_isr_profile_t *profile)
+{
+    vTaskEnterCritical(&isr_profile_mutex);
+    memcpy(profile, &isr_profile, sizeof(st_isr_profile_t));
+    vTaskExitCritical(&isr_profile_mutex);
+}
+
+void st_reset_isr_profile()
+{
+    vTaskEnterCritical(&isr_profile_mutex);
+    memset(&isr_profile, 0, sizeof(st_isr_profile_t));
+    vTaskExitCritical(&isr_profile_mutex);
+}
+#endif
+
+#ifdef STEP_TRACE
+void st_step_trace_hold(bool hold)
+{
+    step_trace_held = hold;
+}
+
+uint32_t st_step_trace_count()
+{
+    return (step_trace_count);
+}
+
+void st_step_trace_get(uint32_t n, st_step_trace_entry_t *entry)
+{
+    vTaskEnterCritical(&step_trace_mutex);
+    memcpy(entry, &step_trace[n & (STEP_TRACE_SIZE - 1)], sizeof(st_step_trace_entry_t));
+    vTaskExitCritical(&step_trace_mutex);
+}
+
+void st_reset_step_trace()
+{
+    vTaskEnterCritical(&step_trace_mutex);
+    step_trace_count = 0;
+    vTaskExitCritical(&step_trace_mutex);
+}
+#endif
+
 void IRAM_ATTR Stepper_Timer_WritePeriod(uint64_t alarm_val)
 {
     timer_set_alarm_value(STEP_TIMER_GROUP, STEP_TIMER_INDEX, alarm_val);
@@ -1037,6 +2697,21 @@ void IRAM_ATTR Stepper_Timer_Stop()
 
 }
 
+// Arms the one-shot step pulse reset timer. Written at register level, because it is called from
+// the stepper driver interrupt on every step.
+void IRAM_ATTR Stepper_Off_Timer_Start()
+{
+    timg_hwtimer_reg_t *off_timer = &TIMERG0.hw_timer[STEP_OFF_TIMER_INDEX];
+    off_timer->config.enable = 0;
+    off_timer->load_high = 0;
+    off_timer->load_low = 0;
+    off_timer->reload = 1; // Any write loads the counter with load_high/load_low.
+    off_timer->alarm_high = 0;
+    off_timer->alarm_low = st.step_pulse_time;
+    off_timer->config.alarm_en = TIMER_ALARM_EN;
+    off_timer->config.enable = 1;
+}
+
 
 void set_stepper_disable(uint8_t isOn)  // isOn = true // to disable
 {
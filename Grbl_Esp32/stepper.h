@@ -14,6 +14,14 @@
 #define SEGMENT_BUFFER_SIZE 6
 #endif
 
+#if SEGMENT_BUFFER_SIZE > 255
+#error "SEGMENT_BUFFER_SIZE must fit the 8-bit segment ring indices."
+#endif
+
+#if defined(USE_SEGMENT_PREP_TASK) && (SEGMENT_BUFFER_LOW_WATER >= SEGMENT_BUFFER_SIZE)
+#error "SEGMENT_BUFFER_LOW_WATER must be less than SEGMENT_BUFFER_SIZE."
+#endif
+
 
 
 #include "grbl.h"
@@ -21,6 +29,10 @@
 
 // Some useful constants.
 #define DT_SEGMENT (1.0/(ACCELERATION_TICKS_PER_SECOND*60.0)) // min/segment
+#ifdef ADAPTIVE_SEGMENT_DURATION
+#define DT_SEGMENT_RAMP (1.0/(SEGMENT_RAMP_TICKS_PER_SECOND*60.0)) // min/segment
+#define DT_SEGMENT_CRUISE (1.0/(SEGMENT_CRUISE_TICKS_PER_SECOND*60.0)) // min/segment
+#endif
 #define REQ_MM_INCREMENT_SCALAR 1.25
 #define RAMP_ACCEL 0
 #define RAMP_CRUISE 1
@@ -29,6 +41,7 @@
 
 #define PREP_FLAG_RECALCULATE bit(0)
 #define PREP_FLAG_HOLD_PARTIAL_BLOCK bit(1)
+#define PREP_FLAG_RECALCULATE_AT_RAMP_END bit(2) // JERK_LIMITED_ACCELERATION only
 #define PREP_FLAG_DECEL_OVERRIDE bit(3)
 
 // Define Adaptive Multi-Axis Step-Smoothing(AMASS) levels and cutoff frequencies. The highest level
@@ -55,6 +68,77 @@ error "AMASS must have 1 or more levels to operate correctly."
 
 #define STEP_TIMER_GROUP TIMER_GROUP_0
 #define STEP_TIMER_INDEX TIMER_0
+#define STEP_OFF_TIMER_INDEX TIMER_1 // Step pulse reset timer. Same group as the stepper timer.
+#define STEPPER_OFF_TICKS_PER_MICROSECOND (F_TIMERS/STEPPER_OFF_TIMER_PRESCALE/1000000)
+
+#ifdef USE_RMT_STEPS
+#define RMT_STEP_CLK_DIV 20 // RMT runs from the 80MHz APB clock. Gives 4 ticks per microsecond.
+#define RMT_STEP_TICKS_PER_MICROSECOND (F_TIMERS/RMT_STEP_CLK_DIV/1000000)
+#endif
+#if defined(STEP_PULSE_DELAY) && !defined(USE_RMT_STEPS)
+#error "STEP_PULSE_DELAY requires USE_RMT_STEPS."
+#endif
+
+#ifdef STEPPER_ISR_PROFILER
+#define ISR_PROFILE_HISTOGRAM_BINS 16 // Bin n counts ISR times of 2^n to 2^(n+1)-1 CPU cycles. Last bin is open.
+
+// Stepper driver interrupt execution statistics. Times are in CPU cycles.
+typedef struct
+{
+    uint32_t count;         // Number of measured ISR ticks
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;  // For the average
+    uint32_t busy_count;    // ISR entries rejected by the busy flag
+    uint32_t late_count;    // Ticks where the next alarm had already passed when the ISR finished
+    uint32_t histogram[ISR_PROFILE_HISTOGRAM_BINS];
+} st_isr_profile_t;
+#endif
+
+#ifdef STEP_TRACE
+#if (STEP_TRACE_SIZE & (STEP_TRACE_SIZE - 1))
+#error "STEP_TRACE_SIZE must be a power of 2."
+#endif
+
+// A step pulse recorded by the stepper ISR
+typedef struct
+{
+    uint32_t cycles;   // CPU cycle counter at the rising step edge
+    uint8_t step_bits; // Axes stepped
+    uint8_t dir_bits;  // Direction bits of the step
+} st_step_trace_entry_t;
+#endif
+
+#ifdef CHECK_MODE_ESTIMATE
+// Run time estimate of the motions of a '$CE' check mode program.
+typedef struct
+{
+    uint64_t motion_ticks;        // Stepper timer ticks of the generated segments
+    float dwell_time;             // Dwells, in seconds
+    uint32_t block_count;         // Planner blocks completed
+    float peak_rate;              // Highest segment rate along the path (mm/min)
+    float peak_axis_rate[N_AXIS]; // Highest segment rate of each axis (mm/min)
+} st_estimate_t;
+#endif
+
+// Ends of motion seen by the stepper ISR and the segment buffer depth while moving. Written only by the ISR.
+typedef struct
+{
+    uint32_t stop_count;       // Stops after the segment generator delivered all of the motion
+    uint32_t starvation_count; // Stops on an empty segment buffer, with motion still to be generated
+    uint8_t cycle_min_depth;   // Fewest segments queued during the current or last cycle
+    uint8_t min_depth;         // Fewest segments queued during any cycle
+} st_underrun_stats_t;
+
+// Segment generator statistics.
+typedef struct
+{
+    uint32_t block_count;         // Planner blocks completed by the segment generator
+    uint32_t segment_count;       // Segments generated for those blocks
+    uint16_t last_block_segments; // Segments generated for the last completed block
+    uint16_t max_block_segments;  // Most segments generated for one block
+    uint8_t buffer_high_water;    // Most segments queued in the segment buffer
+} st_segment_stats_t;
 
 // esp32 work around for diable in main loop
 extern uint64_t stepper_idle_counter;
@@ -64,7 +148,7 @@ extern bool stepper_idle;
 
 
 void IRAM_ATTR onSteppertimer();
-void IRAM_ATTR onStepperOffTimer();
+void IRAM_ATTR onStepperOffTimer(void *para);
 void stepper_init();
 
 // Enable steppers, but cycle does not start unless called by motion control or realtime command.
@@ -82,22 +166,100 @@ void st_reset();
 // Reloads step segment buffer. Called continuously by realtime execution system.
 void st_prep_buffer();
 
+// Serializes planner and segment buffer changes with the segment prep task. Recursive. No-ops,
+// if the segment prep task is disabled in config.h.
+void st_prep_lock();
+void st_prep_unlock();
+
 // Called by planner_recalculate() when the executing block is updated by the new plan.
 void st_update_plan_block_parameters();
 
 // Called by realtime status reporting if realtime rate reporting is enabled in config.h.
 float st_get_realtime_rate();
 
+// Segment generator statistics. Reported and cleared with the ISR profile ($P / $PR).
+void st_get_segment_stats(st_segment_stats_t *stats);
+void st_reset_segment_stats();
+
+// Segment buffer underrun statistics. Reported with '$P' and the status report, cleared with '$PR'.
+void st_get_underrun_stats(st_underrun_stats_t *stats);
+void st_reset_underrun_stats();
+
+// Returns the real-time machine position in steps. Called by status reports and homing.
+void st_get_realtime_position(int32_t *position);
+
+#ifdef STARTUP_CACHE
+// Records the segments handed to the stepper ISR into buffer, from now until st_record_stop(). Used to
+// record the startup blocks, see startup_cache.h.
+void st_record_start(uint8_t *buffer, uint32_t size);
+// Ends the recording. Returns its length in bytes, or 0 if it did not fit or was interrupted.
+uint32_t st_record_stop();
+// Fails the recording. Called at synchronization points, which a recording can not reproduce.
+void st_record_abort();
+
+// Executes a recorded segment stream instead of planner blocks. Returns false, without starting, if
+// the stream is damaged or steps faster than allowed. The stream must stay valid until st_replay_stop().
+bool st_replay_start(const uint8_t *stream, uint32_t size);
+// Ends the replay. Returns true if the whole stream was handed to the stepper ISR.
+bool st_replay_stop();
+#endif
+
+#ifdef CHECK_MODE_ESTIMATE
+// Starts a run time estimate. Until the next st_reset(), check mode plans the motions and executes
+// them with st_estimate_execute() on the stepper timer clock, without stepping.
+void st_estimate_start();
+bool st_estimate_running();
+// Generates and discards the segments of the planned motions and adds up their step timing. Runs
+// until a planner block is free or, if synchronize is set, until all planned motion is done.
+void st_estimate_execute(bool synchronize);
+void st_estimate_dwell(float seconds);
+void st_get_estimate(st_estimate_t *estimate);
+#endif
+
+#ifdef STEP_RATE_GOVERNOR
+// Highest step rate in Hz the stepper ISR sustains, as measured at boot. Limits planned rates.
+float st_get_max_step_rate();
+#endif
+
+#ifdef STEPPER_ISR_PROFILER
+// Copies the stepper ISR execution statistics. Called by the '$P' report.
+void st_get_isr_profile(st_isr_profile_t *profile);
+
+// Clears the stepper ISR execution statistics. Called by '$PR'.
+void st_reset_isr_profile();
+#endif
+
+#ifdef STEP_TRACE
+// Stops or resumes recording step pulses, so the trace can be read while the machine moves.
+void st_step_trace_hold(bool hold);
+
+// Returns the number of step pulses recorded since the trace was cleared. The trace keeps the last
+// STEP_TRACE_SIZE of them.
+uint32_t st_step_trace_count();
+
+// Copies recorded step pulse n, counted from the clear. Only the last STEP_TRACE_SIZE are kept.
+void st_step_trace_get(uint32_t n, st_step_trace_entry_t *entry);
+
+// Clears the step pulse trace. Called by '$TR'.
+void st_reset_step_trace();
+#endif
+
 // disable (or enable) steppers via STEPPERS_DISABLE_PIN
 void set_stepper_disable(uint8_t disable);
 
 void set_step_pin_on(uint8_t axis, uint8_t isOn);
 void set_direction_pin_on(uint8_t axis, uint8_t isOn);
-void set_stepper_pins_on(uint8_t onMask);
-void set_direction_pins_on(uint8_t onMask);
+void IRAM_ATTR set_stepper_pins_on(uint8_t onMask);
+void IRAM_ATTR set_direction_pins_on(uint8_t onMask);
 
 void Stepper_Timer_WritePeriod(uint64_t alarm_val);
 void Stepper_Timer_Start();
 void Stepper_Timer_Stop();
+void Stepper_Off_Timer_Start();
+
+#ifdef USE_RMT_STEPS
+// Loads the step pulse shape and idle levels into the RMT step channels.
+void st_rmt_fill_step_items();
+#endif
 
 #endif
@@ -30,8 +30,8 @@ void system_ini() // Renamed from system_init() due to conflict with esp32 files
     digitalWrite(EV_H20, LOW);
 }
 
-// Executes user startup script, if stored.
-void system_execute_startup()
+// Parses and executes the stored startup blocks, reporting each.
+static void system_execute_startup_lines()
 {
     uint8_t n;
     char line[LINE_BUFFER_SIZE]; // Line to be executed. Zero-terminated.
@@ -54,6 +54,43 @@ void system_execute_startup()
     }
 }
 
+// Executes user startup script, if stored.
+void system_execute_startup()
+{
+#ifdef STARTUP_CACHE
+    // Motion still queued would run after a replay, or end up in a recording. Also, the key holds the
+    // planner position, which is only the machine position once the queued motion completed.
+    protocol_buffer_synchronize();
+    if (sys.abort)
+    {
+        return;
+    }
+    // Replay the recorded segments of unchanged startup blocks. The blocks are only parsed in check
+    // mode then, to bring the parser state to their end and to report them as usual. The recording
+    // holds the speeds of 100% overrides, so other override values plan the blocks without it.
+    if ((sys.f_override != DEFAULT_FEED_OVERRIDE) || (sys.r_override != DEFAULT_RAPID_OVERRIDE))
+    {
+        system_execute_startup_lines();
+        return;
+    }
+    uint32_t cache_key = startup_cache_key();
+    if (startup_cache_load(cache_key))
+    {
+        uint8_t prior_state = sys.state;
+        sys.state = STATE_CHECK_MODE;
+        system_execute_startup_lines();
+        sys.state = prior_state;
+        startup_cache_replay();
+        return;
+    }
+    startup_cache_record_begin();
+#endif
+    system_execute_startup_lines();
+#ifdef STARTUP_CACHE
+    startup_cache_record_end(cache_key);
+#endif
+}
+
 // Directs and executes one line of formatted input from protocol_process. While mostly
 // incoming streaming g-code blocks, this also executes Grbl internal commands, such as
 // settings, initiating the homing cycle, and toggling switch states. This differs from
@@ -106,6 +143,41 @@ uint8_t system_execute_line(char *line, uint8_t client)
                     break;
             }
             break;
+#ifdef STEPPER_ISR_PROFILER
+        case 'P' : // Print or clear stepper ISR statistics. Allowed in any state, also while running.
+            if (line[2] == 0)
+            {
+                report_isr_profile(client);
+            }
+            else if ((line[2] == 'R') && (line[3] == 0))
+            {
+                st_reset_isr_profile();
+                st_reset_segment_stats();
+                st_reset_underrun_stats();
+                plan_reset_recalculate_profile();
+            }
+            else
+            {
+                return (STATUS_INVALID_STATEMENT);
+            }
+            break;
+#endif
+#ifdef STEP_TRACE
+        case 'T' : // Print or clear the step pulse trace. Allowed in any state, also while running.
+            if (line[2] == 0)
+            {
+                report_step_trace(client);
+            }
+            else if ((line[2] == 'R') && (line[3] == 0))
+            {
+                st_reset_step_trace();
+            }
+            else
+            {
+                return (STATUS_INVALID_STATEMENT);
+            }
+            break;
+#endif
         case 'J' : // Jogging
             // Execute only if in IDLE or JOG states.
             if (sys.state != STATE_IDLE && sys.state != STATE_JOG)
@@ -118,9 +190,49 @@ uint8_t system_execute_line(char *line, uint8_t client)
             }
             return (gc_execute_line(line, client)); // NOTE: $J= is ignored inside g-code parser and used to detect jog motions.
             break;
+        case 'C' : // Set check g-code mode [IDLE/CHECK]
+#ifdef CHECK_MODE_ESTIMATE
+            // '$CE' also estimates the run time of the checked program.
+            if ((line[2] != 0) && ((line[2] != 'E') || (line[3] != 0)))
+#else
+            if (line[2] != 0)
+#endif
+            {
+                return (STATUS_INVALID_STATEMENT);
+            }
+            // Perform reset when toggling off. Check g-code mode should only work if Grbl
+            // is idle and ready, regardless of alarm locks. This is mainly to keep things
+            // simple and consistent.
+            if ( sys.state == STATE_CHECK_MODE )
+            {
+#ifdef CHECK_MODE_ESTIMATE
+                if (st_estimate_running())
+                {
+                    st_estimate_execute(true); // Finish the motions still in the planner.
+                    report_run_time_estimate(client);
+                }
+#endif
+                mc_reset();
+                report_feedback_message(MESSAGE_DISABLED);
+            }
+            else
+            {
+                if (sys.state)
+                {
+                    return (STATUS_IDLE_ERROR);  // Requires no alarm mode.
+                }
+                sys.state = STATE_CHECK_MODE;
+#ifdef CHECK_MODE_ESTIMATE
+                if (line[2] == 'E')
+                {
+                    st_estimate_start();
+                }
+#endif
+                report_feedback_message(MESSAGE_ENABLED);
+            }
+            break;
         case '$':
         case 'G':
-        case 'C':
         case 'X':
             if ( line[2] != 0 )
             {
@@ -142,25 +254,6 @@ uint8_t system_execute_line(char *line, uint8_t client)
                     // TODO: Move this to realtime commands for GUIs to request this data during suspend-state.
                     report_gcode_modes(client);
                     break;
-                case 'C' : // Set check g-code mode [IDLE/CHECK]
-                    // Perform reset when toggling off. Check g-code mode should only work if Grbl
-                    // is idle and ready, regardless of alarm locks. This is mainly to keep things
-                    // simple and consistent.
-                    if ( sys.state == STATE_CHECK_MODE )
-                    {
-                        mc_reset();
-                        report_feedback_message(MESSAGE_DISABLED);
-                    }
-                    else
-                    {
-                        if (sys.state)
-                        {
-                            return (STATUS_IDLE_ERROR);  // Requires no alarm mode.
-                        }
-                        sys.state = STATE_CHECK_MODE;
-                        report_feedback_message(MESSAGE_ENABLED);
-                    }
-                    break;
                 case 'X' : // Disable alarm lock [ALARM]
                     if (sys.state == STATE_ALARM)
                     {
@@ -286,6 +379,9 @@ uint8_t system_execute_line(char *line, uint8_t client)
                     report_feedback_message(MESSAGE_RESTORE_DEFAULTS);
                     mc_reset(); // Force reset to ensure settings are initialized correctly.
                     break;
+                case 'W':
+                    //TODO
+                    break;
                 case 'N' : // Startup lines. [IDLE/ALARM]
                     if ( line[++char_counter] == 0 )   // Print startup lines
                     {
@@ -311,9 +407,6 @@ uint8_t system_execute_line(char *line, uint8_t client)
                         helper_var = true;  // Set helper_var to flag storing method. ******
                         // No break. Continues into default: to read remaining command characters.
                     }
-                case 'W':
-                    //TODO
-                    break;
 
                 default :  // Storing setting methods [IDLE/ALARM]
                     if (!read_float(line, &char_counter, &parameter))
@@ -434,7 +527,7 @@ void system_flag_wco_change()
 float system_convert_axis_steps_to_mpos(int32_t *steps, uint8_t idx)
 {
     float pos;
-    pos = steps[idx] / settings.steps_per_mm[idx];
+    pos = steps[idx] * settings_derived.mm_per_step[idx];
     return (pos);
 }
 
@@ -456,26 +549,44 @@ uint8_t system_check_travel_limits(float *target)
     uint8_t idx;
     for (idx = 0; idx < N_AXIS; idx++)
     {
+        float axis_target = target[idx];
+        if (settings_derived.rotary_steps[idx])
+        {
+            // A rotary axis turns without end. Only its angle is checked, brought into the turn
+            // the soft limits span, like plan_normalize_rotary_position() does with the position.
+            float turn = settings.rotary_travel[idx];
+#ifdef HOMING_FORCE_SET_ORIGIN
+            if (bit_istrue(settings.homing_dir_mask, bit(idx)))
+            {
+                turn = -turn; // The turn lies on the positive side of the origin.
+            }
+#endif
+            axis_target = fmodf(axis_target, turn); // Sign of target.
+            if (axis_target * turn > 0)
+            {
+                axis_target -= turn;
+            }
+        }
 #ifdef HOMING_FORCE_SET_ORIGIN
         // When homing forced set origin is enabled, soft limits checks need to account for directionality.
         // NOTE: max_travel is stored as negative
         if (bit_istrue(settings.homing_dir_mask, bit(idx)))
         {
-            if (target[idx] < 0 || target[idx] > -settings.max_travel[idx])
+            if (axis_target < 0 || axis_target > -settings.max_travel[idx])
             {
                 return (true);
             }
         }
         else
         {
-            if (target[idx] > 0 || target[idx] < settings.max_travel[idx])
+            if (axis_target > 0 || axis_target < settings.max_travel[idx])
             {
                 return (true);
             }
         }
 #else
         // NOTE: max_travel is stored as negative
-        if (target[idx] > 0 || target[idx] < settings.max_travel[idx])
+        if (axis_target > 0 || axis_target < settings.max_travel[idx])
         {
             return (true);
         }
@@ -20,6 +20,9 @@ typedef struct
     uint8_t step_control;        // Governs the step segment generator depending on system state.
     uint8_t homing_axis_lock;    // Locks axes when limits engage. Used as an axis motion mask in the stepper ISR.
     uint8_t report_wco_counter;  // Tracks when to add work coordinate offset data to status reports.
+    uint8_t report_ovr_counter;  // Tracks when to add override data to status reports.
+    uint8_t f_override;          // Feed rate override value in percent
+    uint8_t r_override;          // Rapids override value in percent
 
 } system_t;
 extern system_t sys;
@@ -49,6 +52,16 @@ extern system_t sys;
 #define EXEC_ALARM_HOMING_FAIL_PULLOFF  8
 #define EXEC_ALARM_HOMING_FAIL_APPROACH 9
 
+// Override bit maps. Realtime bitflags to control feed and rapid overrides.
+#define EXEC_FEED_OVR_RESET         bit(0)
+#define EXEC_FEED_OVR_COARSE_PLUS   bit(1)
+#define EXEC_FEED_OVR_COARSE_MINUS  bit(2)
+#define EXEC_FEED_OVR_FINE_PLUS     bit(3)
+#define EXEC_FEED_OVR_FINE_MINUS    bit(4)
+#define EXEC_RAPID_OVR_RESET        bit(5)
+#define EXEC_RAPID_OVR_MEDIUM       bit(6)
+#define EXEC_RAPID_OVR_LOW          bit(7)
+
 
 // Define system state bit map. The state variable primarily tracks the individual functions
 // of Grbl to manage each without overlapping. It is also used as a messaging flag for
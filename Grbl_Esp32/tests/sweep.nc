@@ -0,0 +1,1613 @@
+(Planner benchmark. Sweeps of short lines along a shallow curve, like a raster of a curved surface.)
+(Run by 'make bench' in sim/, which compares the planner recalculations for different BLOCK_BUFFER_SIZE values.)
+$X
+G90
+G0 X0 Y0
+F6000
+G1 X0.0 Y1.000
+G1 X0.5 Y1.008
+G1 X1.0 Y1.017
+G1 X1.5 Y1.025
+G1 X2.0 Y1.033
+G1 X2.5 Y1.042
+G1 X3.0 Y1.050
+G1 X3.5 Y1.058
+G1 X4.0 Y1.066
+G1 X4.5 Y1.075
+G1 X5.0 Y1.083
+G1 X5.5 Y1.091
+G1 X6.0 Y1.099
+G1 X6.5 Y1.107
+G1 X7.0 Y1.116
+G1 X7.5 Y1.124
+G1 X8.0 Y1.132
+G1 X8.5 Y1.140
+G1 X9.0 Y1.148
+G1 X9.5 Y1.156
+G1 X10.0 Y1.164
+G1 X10.5 Y1.171
+G1 X11.0 Y1.179
+G1 X11.5 Y1.187
+G1 X12.0 Y1.195
+G1 X12.5 Y1.202
+G1 X13.0 Y1.210
+G1 X13.5 Y1.217
+G1 X14.0 Y1.225
+G1 X14.5 Y1.232
+G1 X15.0 Y1.240
+G1 X15.5 Y1.247
+G1 X16.0 Y1.254
+G1 X16.5 Y1.261
+G1 X17.0 Y1.268
+G1 X17.5 Y1.275
+G1 X18.0 Y1.282
+G1 X18.5 Y1.289
+G1 X19.0 Y1.296
+G1 X19.5 Y1.303
+G1 X20.0 Y1.309
+G1 X20.5 Y1.316
+G1 X21.0 Y1.322
+G1 X21.5 Y1.328
+G1 X22.0 Y1.335
+G1 X22.5 Y1.341
+G1 X23.0 Y1.347
+G1 X23.5 Y1.353
+G1 X24.0 Y1.359
+G1 X24.5 Y1.364
+G1 X25.0 Y1.370
+G1 X25.5 Y1.376
+G1 X26.0 Y1.381
+G1 X26.5 Y1.386
+G1 X27.0 Y1.392
+G1 X27.5 Y1.397
+G1 X28.0 Y1.402
+G1 X28.5 Y1.407
+G1 X29.0 Y1.411
+G1 X29.5 Y1.416
+G1 X30.0 Y1.421
+G1 X30.5 Y1.425
+G1 X31.0 Y1.430
+G1 X31.5 Y1.434
+G1 X32.0 Y1.438
+G1 X32.5 Y1.442
+G1 X33.0 Y1.446
+G1 X33.5 Y1.449
+G1 X34.0 Y1.453
+G1 X34.5 Y1.456
+G1 X35.0 Y1.460
+G1 X35.5 Y1.463
+G1 X36.0 Y1.466
+G1 X36.5 Y1.469
+G1 X37.0 Y1.472
+G1 X37.5 Y1.474
+G1 X38.0 Y1.477
+G1 X38.5 Y1.479
+G1 X39.0 Y1.482
+G1 X39.5 Y1.484
+G1 X40.0 Y1.486
+G1 X40.5 Y1.488
+G1 X41.0 Y1.490
+G1 X41.5 Y1.491
+G1 X42.0 Y1.493
+G1 X42.5 Y1.494
+G1 X43.0 Y1.495
+G1 X43.5 Y1.496
+G1 X44.0 Y1.497
+G1 X44.5 Y1.498
+G1 X45.0 Y1.499
+G1 X45.5 Y1.499
+G1 X46.0 Y1.500
+G1 X46.5 Y1.500
+G1 X47.0 Y1.500
+G1 X47.5 Y1.500
+G1 X48.0 Y1.500
+G1 X48.5 Y1.499
+G1 X49.0 Y1.499
+G1 X49.5 Y1.498
+G1 X50.0 Y1.498
+G1 X50.5 Y1.497
+G1 X51.0 Y1.496
+G1 X51.5 Y1.495
+G1 X52.0 Y1.493
+G1 X52.5 Y1.492
+G1 X53.0 Y1.490
+G1 X53.5 Y1.489
+G1 X54.0 Y1.487
+G1 X54.5 Y1.485
+G1 X55.0 Y1.483
+G1 X55.5 Y1.481
+G1 X56.0 Y1.478
+G1 X56.5 Y1.476
+G1 X57.0 Y1.473
+G1 X57.5 Y1.470
+G1 X58.0 Y1.468
+G1 X58.5 Y1.464
+G1 X59.0 Y1.461
+G1 X59.5 Y1.458
+G1 X60.0 Y1.455
+G1 X60.5 Y1.451
+G1 X61.0 Y1.447
+G1 X61.5 Y1.444
+G1 X62.0 Y1.440
+G1 X62.5 Y1.436
+G1 X63.0 Y1.432
+G1 X63.5 Y1.427
+G1 X64.0 Y1.423
+G1 X64.5 Y1.418
+G1 X65.0 Y1.414
+G1 X65.5 Y1.409
+G1 X66.0 Y1.404
+G1 X66.5 Y1.399
+G1 X67.0 Y1.394
+G1 X67.5 Y1.389
+G1 X68.0 Y1.384
+G1 X68.5 Y1.378
+G1 X69.0 Y1.373
+G1 X69.5 Y1.367
+G1 X70.0 Y1.362
+G1 X70.5 Y1.356
+G1 X71.0 Y1.350
+G1 X71.5 Y1.344
+G1 X72.0 Y1.338
+G1 X72.5 Y1.332
+G1 X73.0 Y1.325
+G1 X73.5 Y1.319
+G1 X74.0 Y1.312
+G1 X74.5 Y1.306
+G1 X75.0 Y1.299
+G1 X75.5 Y1.293
+G1 X76.0 Y1.286
+G1 X76.5 Y1.279
+G1 X77.0 Y1.272
+G1 X77.5 Y1.265
+G1 X78.0 Y1.258
+G1 X78.5 Y1.251
+G1 X79.0 Y1.243
+G1 X79.5 Y1.236
+G1 X80.0 Y1.229
+G1 X80.5 Y1.221
+G1 X81.0 Y1.214
+G1 X81.5 Y1.206
+G1 X82.0 Y1.199
+G1 X82.5 Y1.191
+G1 X83.0 Y1.183
+G1 X83.5 Y1.175
+G1 X84.0 Y1.167
+G1 X84.5 Y1.160
+G1 X85.0 Y1.152
+G1 X85.5 Y1.144
+G1 X86.0 Y1.136
+G1 X86.5 Y1.128
+G1 X87.0 Y1.120
+G1 X87.5 Y1.112
+G1 X88.0 Y1.103
+G1 X88.5 Y1.095
+G1 X89.0 Y1.087
+G1 X89.5 Y1.079
+G1 X90.0 Y1.071
+G1 X90.5 Y1.062
+G1 X91.0 Y1.054
+G1 X91.5 Y1.046
+G1 X92.0 Y1.037
+G1 X92.5 Y1.029
+G1 X93.0 Y1.021
+G1 X93.5 Y1.012
+G1 X94.0 Y1.004
+G1 X94.5 Y0.996
+G1 X95.0 Y0.987
+G1 X95.5 Y0.979
+G1 X96.0 Y0.971
+G1 X96.5 Y0.962
+G1 X97.0 Y0.954
+G1 X97.5 Y0.946
+G1 X98.0 Y0.938
+G1 X98.5 Y0.929
+G1 X99.0 Y0.921
+G1 X99.5 Y0.913
+G1 X100.0 Y0.905
+G1 X100.5 Y0.897
+G1 X101.0 Y0.888
+G1 X101.5 Y0.880
+G1 X102.0 Y0.872
+G1 X102.5 Y0.864
+G1 X103.0 Y0.856
+G1 X103.5 Y0.848
+G1 X104.0 Y0.840
+G1 X104.5 Y0.832
+G1 X105.0 Y0.825
+G1 X105.5 Y0.817
+G1 X106.0 Y0.809
+G1 X106.5 Y0.801
+G1 X107.0 Y0.794
+G1 X107.5 Y0.786
+G1 X108.0 Y0.779
+G1 X108.5 Y0.771
+G1 X109.0 Y0.764
+G1 X109.5 Y0.757
+G1 X110.0 Y0.749
+G1 X110.5 Y0.742
+G1 X111.0 Y0.735
+G1 X111.5 Y0.728
+G1 X112.0 Y0.721
+G1 X112.5 Y0.714
+G1 X113.0 Y0.707
+G1 X113.5 Y0.701
+G1 X114.0 Y0.694
+G1 X114.5 Y0.688
+G1 X115.0 Y0.681
+G1 X115.5 Y0.675
+G1 X116.0 Y0.668
+G1 X116.5 Y0.662
+G1 X117.0 Y0.656
+G1 X117.5 Y0.650
+G1 X118.0 Y0.644
+G1 X118.5 Y0.638
+G1 X119.0 Y0.633
+G1 X119.5 Y0.627
+G1 X120.0 Y0.622
+G1 X120.5 Y0.616
+G1 X121.0 Y0.611
+G1 X121.5 Y0.606
+G1 X122.0 Y0.601
+G1 X122.5 Y0.596
+G1 X123.0 Y0.591
+G1 X123.5 Y0.586
+G1 X124.0 Y0.582
+G1 X124.5 Y0.577
+G1 X125.0 Y0.573
+G1 X125.5 Y0.568
+G1 X126.0 Y0.564
+G1 X126.5 Y0.560
+G1 X127.0 Y0.556
+G1 X127.5 Y0.553
+G1 X128.0 Y0.549
+G1 X128.5 Y0.545
+G1 X129.0 Y0.542
+G1 X129.5 Y0.539
+G1 X130.0 Y0.535
+G1 X130.5 Y0.532
+G1 X131.0 Y0.530
+G1 X131.5 Y0.527
+G1 X132.0 Y0.524
+G1 X132.5 Y0.522
+G1 X133.0 Y0.519
+G1 X133.5 Y0.517
+G1 X134.0 Y0.515
+G1 X134.5 Y0.513
+G1 X135.0 Y0.511
+G1 X135.5 Y0.510
+G1 X136.0 Y0.508
+G1 X136.5 Y0.507
+G1 X137.0 Y0.505
+G1 X137.5 Y0.504
+G1 X138.0 Y0.503
+G1 X138.5 Y0.502
+G1 X139.0 Y0.502
+G1 X139.5 Y0.501
+G1 X140.0 Y0.501
+G1 X140.5 Y0.500
+G1 X141.0 Y0.500
+G1 X141.5 Y0.500
+G1 X142.0 Y0.500
+G1 X142.5 Y0.500
+G1 X143.0 Y0.501
+G1 X143.5 Y0.501
+G1 X144.0 Y0.502
+G1 X144.5 Y0.503
+G1 X145.0 Y0.504
+G1 X145.5 Y0.505
+G1 X146.0 Y0.506
+G1 X146.5 Y0.507
+G1 X147.0 Y0.509
+G1 X147.5 Y0.510
+G1 X148.0 Y0.512
+G1 X148.5 Y0.514
+G1 X149.0 Y0.516
+G1 X149.5 Y0.518
+G1 X150.0 Y0.521
+G1 X150.5 Y0.523
+G1 X151.0 Y0.526
+G1 X151.5 Y0.528
+G1 X152.0 Y0.531
+G1 X152.5 Y0.534
+G1 X153.0 Y0.537
+G1 X153.5 Y0.540
+G1 X154.0 Y0.544
+G1 X154.5 Y0.547
+G1 X155.0 Y0.551
+G1 X155.5 Y0.554
+G1 X156.0 Y0.558
+G1 X156.5 Y0.562
+G1 X157.0 Y0.566
+G1 X157.5 Y0.571
+G1 X158.0 Y0.575
+G1 X158.5 Y0.579
+G1 X159.0 Y0.584
+G1 X159.5 Y0.589
+G1 X160.0 Y0.593
+G1 X160.5 Y0.598
+G1 X161.0 Y0.603
+G1 X161.5 Y0.608
+G1 X162.0 Y0.614
+G1 X162.5 Y0.619
+G1 X163.0 Y0.624
+G1 X163.5 Y0.630
+G1 X164.0 Y0.636
+G1 X164.5 Y0.641
+G1 X165.0 Y0.647
+G1 X165.5 Y0.653
+G1 X166.0 Y0.659
+G1 X166.5 Y0.665
+G1 X167.0 Y0.672
+G1 X167.5 Y0.678
+G1 X168.0 Y0.684
+G1 X168.5 Y0.691
+G1 X169.0 Y0.697
+G1 X169.5 Y0.704
+G1 X170.0 Y0.711
+G1 X170.5 Y0.718
+G1 X171.0 Y0.725
+G1 X171.5 Y0.732
+G1 X172.0 Y0.739
+G1 X172.5 Y0.746
+G1 X173.0 Y0.753
+G1 X173.5 Y0.760
+G1 X174.0 Y0.768
+G1 X174.5 Y0.775
+G1 X175.0 Y0.783
+G1 X175.5 Y0.790
+G1 X176.0 Y0.798
+G1 X176.5 Y0.805
+G1 X177.0 Y0.813
+G1 X177.5 Y0.821
+G1 X178.0 Y0.829
+G1 X178.5 Y0.836
+G1 X179.0 Y0.844
+G1 X179.5 Y0.852
+G1 X180.0 Y0.860
+G1 X180.5 Y0.868
+G1 X181.0 Y0.876
+G1 X181.5 Y0.884
+G1 X182.0 Y0.893
+G1 X182.5 Y0.901
+G1 X183.0 Y0.909
+G1 X183.5 Y0.917
+G1 X184.0 Y0.925
+G1 X184.5 Y0.934
+G1 X185.0 Y0.942
+G1 X185.5 Y0.950
+G1 X186.0 Y0.958
+G1 X186.5 Y0.967
+G1 X187.0 Y0.975
+G1 X187.5 Y0.983
+G1 X188.0 Y0.992
+G1 X188.5 Y1.000
+G1 X189.0 Y1.008
+G1 X189.5 Y1.017
+G1 X190.0 Y1.025
+G1 X190.5 Y1.033
+G1 X191.0 Y1.042
+G1 X191.5 Y1.050
+G1 X192.0 Y1.058
+G1 X192.5 Y1.067
+G1 X193.0 Y1.075
+G1 X193.5 Y1.083
+G1 X194.0 Y1.091
+G1 X194.5 Y1.099
+G1 X195.0 Y1.108
+G1 X195.5 Y1.116
+G1 X196.0 Y1.124
+G1 X196.5 Y1.132
+G1 X197.0 Y1.140
+G1 X197.5 Y1.148
+G1 X198.0 Y1.156
+G1 X198.5 Y1.164
+G1 X199.0 Y1.172
+G1 X199.5 Y1.179
+G1 X200.0 Y1.187
+G1 X200.0 Y2.187
+G1 X199.5 Y2.179
+G1 X199.0 Y2.172
+G1 X198.5 Y2.164
+G1 X198.0 Y2.156
+G1 X197.5 Y2.148
+G1 X197.0 Y2.140
+G1 X196.5 Y2.132
+G1 X196.0 Y2.124
+G1 X195.5 Y2.116
+G1 X195.0 Y2.108
+G1 X194.5 Y2.099
+G1 X194.0 Y2.091
+G1 X193.5 Y2.083
+G1 X193.0 Y2.075
+G1 X192.5 Y2.067
+G1 X192.0 Y2.058
+G1 X191.5 Y2.050
+G1 X191.0 Y2.042
+G1 X190.5 Y2.033
+G1 X190.0 Y2.025
+G1 X189.5 Y2.017
+G1 X189.0 Y2.008
+G1 X188.5 Y2.000
+G1 X188.0 Y1.992
+G1 X187.5 Y1.983
+G1 X187.0 Y1.975
+G1 X186.5 Y1.967
+G1 X186.0 Y1.958
+G1 X185.5 Y1.950
+G1 X185.0 Y1.942
+G1 X184.5 Y1.934
+G1 X184.0 Y1.925
+G1 X183.5 Y1.917
+G1 X183.0 Y1.909
+G1 X182.5 Y1.901
+G1 X182.0 Y1.893
+G1 X181.5 Y1.884
+G1 X181.0 Y1.876
+G1 X180.5 Y1.868
+G1 X180.0 Y1.860
+G1 X179.5 Y1.852
+G1 X179.0 Y1.844
+G1 X178.5 Y1.836
+G1 X178.0 Y1.829
+G1 X177.5 Y1.821
+G1 X177.0 Y1.813
+G1 X176.5 Y1.805
+G1 X176.0 Y1.798
+G1 X175.5 Y1.790
+G1 X175.0 Y1.783
+G1 X174.5 Y1.775
+G1 X174.0 Y1.768
+G1 X173.5 Y1.760
+G1 X173.0 Y1.753
+G1 X172.5 Y1.746
+G1 X172.0 Y1.739
+G1 X171.5 Y1.732
+G1 X171.0 Y1.725
+G1 X170.5 Y1.718
+G1 X170.0 Y1.711
+G1 X169.5 Y1.704
+G1 X169.0 Y1.697
+G1 X168.5 Y1.691
+G1 X168.0 Y1.684
+G1 X167.5 Y1.678
+G1 X167.0 Y1.672
+G1 X166.5 Y1.665
+G1 X166.0 Y1.659
+G1 X165.5 Y1.653
+G1 X165.0 Y1.647
+G1 X164.5 Y1.641
+G1 X164.0 Y1.636
+G1 X163.5 Y1.630
+G1 X163.0 Y1.624
+G1 X162.5 Y1.619
+G1 X162.0 Y1.614
+G1 X161.5 Y1.608
+G1 X161.0 Y1.603
+G1 X160.5 Y1.598
+G1 X160.0 Y1.593
+G1 X159.5 Y1.589
+G1 X159.0 Y1.584
+G1 X158.5 Y1.579
+G1 X158.0 Y1.575
+G1 X157.5 Y1.571
+G1 X157.0 Y1.566
+G1 X156.5 Y1.562
+G1 X156.0 Y1.558
+G1 X155.5 Y1.554
+G1 X155.0 Y1.551
+G1 X154.5 Y1.547
+G1 X154.0 Y1.544
+G1 X153.5 Y1.540
+G1 X153.0 Y1.537
+G1 X152.5 Y1.534
+G1 X152.0 Y1.531
+G1 X151.5 Y1.528
+G1 X151.0 Y1.526
+G1 X150.5 Y1.523
+G1 X150.0 Y1.521
+G1 X149.5 Y1.518
+G1 X149.0 Y1.516
+G1 X148.5 Y1.514
+G1 X148.0 Y1.512
+G1 X147.5 Y1.510
+G1 X147.0 Y1.509
+G1 X146.5 Y1.507
+G1 X146.0 Y1.506
+G1 X145.5 Y1.505
+G1 X145.0 Y1.504
+G1 X144.5 Y1.503
+G1 X144.0 Y1.502
+G1 X143.5 Y1.501
+G1 X143.0 Y1.501
+G1 X142.5 Y1.500
+G1 X142.0 Y1.500
+G1 X141.5 Y1.500
+G1 X141.0 Y1.500
+G1 X140.5 Y1.500
+G1 X140.0 Y1.501
+G1 X139.5 Y1.501
+G1 X139.0 Y1.502
+G1 X138.5 Y1.502
+G1 X138.0 Y1.503
+G1 X137.5 Y1.504
+G1 X137.0 Y1.505
+G1 X136.5 Y1.507
+G1 X136.0 Y1.508
+G1 X135.5 Y1.510
+G1 X135.0 Y1.511
+G1 X134.5 Y1.513
+G1 X134.0 Y1.515
+G1 X133.5 Y1.517
+G1 X133.0 Y1.519
+G1 X132.5 Y1.522
+G1 X132.0 Y1.524
+G1 X131.5 Y1.527
+G1 X131.0 Y1.530
+G1 X130.5 Y1.532
+G1 X130.0 Y1.535
+G1 X129.5 Y1.539
+G1 X129.0 Y1.542
+G1 X128.5 Y1.545
+G1 X128.0 Y1.549
+G1 X127.5 Y1.553
+G1 X127.0 Y1.556
+G1 X126.5 Y1.560
+G1 X126.0 Y1.564
+G1 X125.5 Y1.568
+G1 X125.0 Y1.573
+G1 X124.5 Y1.577
+G1 X124.0 Y1.582
+G1 X123.5 Y1.586
+G1 X123.0 Y1.591
+G1 X122.5 Y1.596
+G1 X122.0 Y1.601
+G1 X121.5 Y1.606
+G1 X121.0 Y1.611
+G1 X120.5 Y1.616
+G1 X120.0 Y1.622
+G1 X119.5 Y1.627
+G1 X119.0 Y1.633
+G1 X118.5 Y1.638
+G1 X118.0 Y1.644
+G1 X117.5 Y1.650
+G1 X117.0 Y1.656
+G1 X116.5 Y1.662
+G1 X116.0 Y1.668
+G1 X115.5 Y1.675
+G1 X115.0 Y1.681
+G1 X114.5 Y1.688
+G1 X114.0 Y1.694
+G1 X113.5 Y1.701
+G1 X113.0 Y1.707
+G1 X112.5 Y1.714
+G1 X112.0 Y1.721
+G1 X111.5 Y1.728
+G1 X111.0 Y1.735
+G1 X110.5 Y1.742
+G1 X110.0 Y1.749
+G1 X109.5 Y1.757
+G1 X109.0 Y1.764
+G1 X108.5 Y1.771
+G1 X108.0 Y1.779
+G1 X107.5 Y1.786
+G1 X107.0 Y1.794
+G1 X106.5 Y1.801
+G1 X106.0 Y1.809
+G1 X105.5 Y1.817
+G1 X105.0 Y1.825
+G1 X104.5 Y1.832
+G1 X104.0 Y1.840
+G1 X103.5 Y1.848
+G1 X103.0 Y1.856
+G1 X102.5 Y1.864
+G1 X102.0 Y1.872
+G1 X101.5 Y1.880
+G1 X101.0 Y1.888
+G1 X100.5 Y1.897
+G1 X100.0 Y1.905
+G1 X99.5 Y1.913
+G1 X99.0 Y1.921
+G1 X98.5 Y1.929
+G1 X98.0 Y1.938
+G1 X97.5 Y1.946
+G1 X97.0 Y1.954
+G1 X96.5 Y1.962
+G1 X96.0 Y1.971
+G1 X95.5 Y1.979
+G1 X95.0 Y1.987
+G1 X94.5 Y1.996
+G1 X94.0 Y2.004
+G1 X93.5 Y2.012
+G1 X93.0 Y2.021
+G1 X92.5 Y2.029
+G1 X92.0 Y2.037
+G1 X91.5 Y2.046
+G1 X91.0 Y2.054
+G1 X90.5 Y2.062
+G1 X90.0 Y2.071
+G1 X89.5 Y2.079
+G1 X89.0 Y2.087
+G1 X88.5 Y2.095
+G1 X88.0 Y2.103
+G1 X87.5 Y2.112
+G1 X87.0 Y2.120
+G1 X86.5 Y2.128
+G1 X86.0 Y2.136
+G1 X85.5 Y2.144
+G1 X85.0 Y2.152
+G1 X84.5 Y2.160
+G1 X84.0 Y2.167
+G1 X83.5 Y2.175
+G1 X83.0 Y2.183
+G1 X82.5 Y2.191
+G1 X82.0 Y2.199
+G1 X81.5 Y2.206
+G1 X81.0 Y2.214
+G1 X80.5 Y2.221
+G1 X80.0 Y2.229
+G1 X79.5 Y2.236
+G1 X79.0 Y2.243
+G1 X78.5 Y2.251
+G1 X78.0 Y2.258
+G1 X77.5 Y2.265
+G1 X77.0 Y2.272
+G1 X76.5 Y2.279
+G1 X76.0 Y2.286
+G1 X75.5 Y2.293
+G1 X75.0 Y2.299
+G1 X74.5 Y2.306
+G1 X74.0 Y2.312
+G1 X73.5 Y2.319
+G1 X73.0 Y2.325
+G1 X72.5 Y2.332
+G1 X72.0 Y2.338
+G1 X71.5 Y2.344
+G1 X71.0 Y2.350
+G1 X70.5 Y2.356
+G1 X70.0 Y2.362
+G1 X69.5 Y2.367
+G1 X69.0 Y2.373
+G1 X68.5 Y2.378
+G1 X68.0 Y2.384
+G1 X67.5 Y2.389
+G1 X67.0 Y2.394
+G1 X66.5 Y2.399
+G1 X66.0 Y2.404
+G1 X65.5 Y2.409
+G1 X65.0 Y2.414
+G1 X64.5 Y2.418
+G1 X64.0 Y2.423
+G1 X63.5 Y2.427
+G1 X63.0 Y2.432
+G1 X62.5 Y2.436
+G1 X62.0 Y2.440
+G1 X61.5 Y2.444
+G1 X61.0 Y2.447
+G1 X60.5 Y2.451
+G1 X60.0 Y2.455
+G1 X59.5 Y2.458
+G1 X59.0 Y2.461
+G1 X58.5 Y2.464
+G1 X58.0 Y2.468
+G1 X57.5 Y2.470
+G1 X57.0 Y2.473
+G1 X56.5 Y2.476
+G1 X56.0 Y2.478
+G1 X55.5 Y2.481
+G1 X55.0 Y2.483
+G1 X54.5 Y2.485
+G1 X54.0 Y2.487
+G1 X53.5 Y2.489
+G1 X53.0 Y2.490
+G1 X52.5 Y2.492
+G1 X52.0 Y2.493
+G1 X51.5 Y2.495
+G1 X51.0 Y2.496
+G1 X50.5 Y2.497
+G1 X50.0 Y2.498
+G1 X49.5 Y2.498
+G1 X49.0 Y2.499
+G1 X48.5 Y2.499
+G1 X48.0 Y2.500
+G1 X47.5 Y2.500
+G1 X47.0 Y2.500
+G1 X46.5 Y2.500
+G1 X46.0 Y2.500
+G1 X45.5 Y2.499
+G1 X45.0 Y2.499
+G1 X44.5 Y2.498
+G1 X44.0 Y2.497
+G1 X43.5 Y2.496
+G1 X43.0 Y2.495
+G1 X42.5 Y2.494
+G1 X42.0 Y2.493
+G1 X41.5 Y2.491
+G1 X41.0 Y2.490
+G1 X40.5 Y2.488
+G1 X40.0 Y2.486
+G1 X39.5 Y2.484
+G1 X39.0 Y2.482
+G1 X38.5 Y2.479
+G1 X38.0 Y2.477
+G1 X37.5 Y2.474
+G1 X37.0 Y2.472
+G1 X36.5 Y2.469
+G1 X36.0 Y2.466
+G1 X35.5 Y2.463
+G1 X35.0 Y2.460
+G1 X34.5 Y2.456
+G1 X34.0 Y2.453
+G1 X33.5 Y2.449
+G1 X33.0 Y2.446
+G1 X32.5 Y2.442
+G1 X32.0 Y2.438
+G1 X31.5 Y2.434
+G1 X31.0 Y2.430
+G1 X30.5 Y2.425
+G1 X30.0 Y2.421
+G1 X29.5 Y2.416
+G1 X29.0 Y2.411
+G1 X28.5 Y2.407
+G1 X28.0 Y2.402
+G1 X27.5 Y2.397
+G1 X27.0 Y2.392
+G1 X26.5 Y2.386
+G1 X26.0 Y2.381
+G1 X25.5 Y2.376
+G1 X25.0 Y2.370
+G1 X24.5 Y2.364
+G1 X24.0 Y2.359
+G1 X23.5 Y2.353
+G1 X23.0 Y2.347
+G1 X22.5 Y2.341
+G1 X22.0 Y2.335
+G1 X21.5 Y2.328
+G1 X21.0 Y2.322
+G1 X20.5 Y2.316
+G1 X20.0 Y2.309
+G1 X19.5 Y2.303
+G1 X19.0 Y2.296
+G1 X18.5 Y2.289
+G1 X18.0 Y2.282
+G1 X17.5 Y2.275
+G1 X17.0 Y2.268
+G1 X16.5 Y2.261
+G1 X16.0 Y2.254
+G1 X15.5 Y2.247
+G1 X15.0 Y2.240
+G1 X14.5 Y2.232
+G1 X14.0 Y2.225
+G1 X13.5 Y2.217
+G1 X13.0 Y2.210
+G1 X12.5 Y2.202
+G1 X12.0 Y2.195
+G1 X11.5 Y2.187
+G1 X11.0 Y2.179
+G1 X10.5 Y2.171
+G1 X10.0 Y2.164
+G1 X9.5 Y2.156
+G1 X9.0 Y2.148
+G1 X8.5 Y2.140
+G1 X8.0 Y2.132
+G1 X7.5 Y2.124
+G1 X7.0 Y2.116
+G1 X6.5 Y2.107
+G1 X6.0 Y2.099
+G1 X5.5 Y2.091
+G1 X5.0 Y2.083
+G1 X4.5 Y2.075
+G1 X4.0 Y2.066
+G1 X3.5 Y2.058
+G1 X3.0 Y2.050
+G1 X2.5 Y2.042
+G1 X2.0 Y2.033
+G1 X1.5 Y2.025
+G1 X1.0 Y2.017
+G1 X0.5 Y2.008
+G1 X0.0 Y2.000
+G1 X0.0 Y3.000
+G1 X0.5 Y3.008
+G1 X1.0 Y3.017
+G1 X1.5 Y3.025
+G1 X2.0 Y3.033
+G1 X2.5 Y3.042
+G1 X3.0 Y3.050
+G1 X3.5 Y3.058
+G1 X4.0 Y3.066
+G1 X4.5 Y3.075
+G1 X5.0 Y3.083
+G1 X5.5 Y3.091
+G1 X6.0 Y3.099
+G1 X6.5 Y3.107
+G1 X7.0 Y3.116
+G1 X7.5 Y3.124
+G1 X8.0 Y3.132
+G1 X8.5 Y3.140
+G1 X9.0 Y3.148
+G1 X9.5 Y3.156
+G1 X10.0 Y3.164
+G1 X10.5 Y3.171
+G1 X11.0 Y3.179
+G1 X11.5 Y3.187
+G1 X12.0 Y3.195
+G1 X12.5 Y3.202
+G1 X13.0 Y3.210
+G1 X13.5 Y3.217
+G1 X14.0 Y3.225
+G1 X14.5 Y3.232
+G1 X15.0 Y3.240
+G1 X15.5 Y3.247
+G1 X16.0 Y3.254
+G1 X16.5 Y3.261
+G1 X17.0 Y3.268
+G1 X17.5 Y3.275
+G1 X18.0 Y3.282
+G1 X18.5 Y3.289
+G1 X19.0 Y3.296
+G1 X19.5 Y3.303
+G1 X20.0 Y3.309
+G1 X20.5 Y3.316
+G1 X21.0 Y3.322
+G1 X21.5 Y3.328
+G1 X22.0 Y3.335
+G1 X22.5 Y3.341
+G1 X23.0 Y3.347
+G1 X23.5 Y3.353
+G1 X24.0 Y3.359
+G1 X24.5 Y3.364
+G1 X25.0 Y3.370
+G1 X25.5 Y3.376
+G1 X26.0 Y3.381
+G1 X26.5 Y3.386
+G1 X27.0 Y3.392
+G1 X27.5 Y3.397
+G1 X28.0 Y3.402
+G1 X28.5 Y3.407
+G1 X29.0 Y3.411
+G1 X29.5 Y3.416
+G1 X30.0 Y3.421
+G1 X30.5 Y3.425
+G1 X31.0 Y3.430
+G1 X31.5 Y3.434
+G1 X32.0 Y3.438
+G1 X32.5 Y3.442
+G1 X33.0 Y3.446
+G1 X33.5 Y3.449
+G1 X34.0 Y3.453
+G1 X34.5 Y3.456
+G1 X35.0 Y3.460
+G1 X35.5 Y3.463
+G1 X36.0 Y3.466
+G1 X36.5 Y3.469
+G1 X37.0 Y3.472
+G1 X37.5 Y3.474
+G1 X38.0 Y3.477
+G1 X38.5 Y3.479
+G1 X39.0 Y3.482
+G1 X39.5 Y3.484
+G1 X40.0 Y3.486
+G1 X40.5 Y3.488
+G1 X41.0 Y3.490
+G1 X41.5 Y3.491
+G1 X42.0 Y3.493
+G1 X42.5 Y3.494
+G1 X43.0 Y3.495
+G1 X43.5 Y3.496
+G1 X44.0 Y3.497
+G1 X44.5 Y3.498
+G1 X45.0 Y3.499
+G1 X45.5 Y3.499
+G1 X46.0 Y3.500
+G1 X46.5 Y3.500
+G1 X47.0 Y3.500
+G1 X47.5 Y3.500
+G1 X48.0 Y3.500
+G1 X48.5 Y3.499
+G1 X49.0 Y3.499
+G1 X49.5 Y3.498
+G1 X50.0 Y3.498
+G1 X50.5 Y3.497
+G1 X51.0 Y3.496
+G1 X51.5 Y3.495
+G1 X52.0 Y3.493
+G1 X52.5 Y3.492
+G1 X53.0 Y3.490
+G1 X53.5 Y3.489
+G1 X54.0 Y3.487
+G1 X54.5 Y3.485
+G1 X55.0 Y3.483
+G1 X55.5 Y3.481
+G1 X56.0 Y3.478
+G1 X56.5 Y3.476
+G1 X57.0 Y3.473
+G1 X57.5 Y3.470
+G1 X58.0 Y3.468
+G1 X58.5 Y3.464
+G1 X59.0 Y3.461
+G1 X59.5 Y3.458
+G1 X60.0 Y3.455
+G1 X60.5 Y3.451
+G1 X61.0 Y3.447
+G1 X61.5 Y3.444
+G1 X62.0 Y3.440
+G1 X62.5 Y3.436
+G1 X63.0 Y3.432
+G1 X63.5 Y3.427
+G1 X64.0 Y3.423
+G1 X64.5 Y3.418
+G1 X65.0 Y3.414
+G1 X65.5 Y3.409
+G1 X66.0 Y3.404
+G1 X66.5 Y3.399
+G1 X67.0 Y3.394
+G1 X67.5 Y3.389
+G1 X68.0 Y3.384
+G1 X68.5 Y3.378
+G1 X69.0 Y3.373
+G1 X69.5 Y3.367
+G1 X70.0 Y3.362
+G1 X70.5 Y3.356
+G1 X71.0 Y3.350
+G1 X71.5 Y3.344
+G1 X72.0 Y3.338
+G1 X72.5 Y3.332
+G1 X73.0 Y3.325
+G1 X73.5 Y3.319
+G1 X74.0 Y3.312
+G1 X74.5 Y3.306
+G1 X75.0 Y3.299
+G1 X75.5 Y3.293
+G1 X76.0 Y3.286
+G1 X76.5 Y3.279
+G1 X77.0 Y3.272
+G1 X77.5 Y3.265
+G1 X78.0 Y3.258
+G1 X78.5 Y3.251
+G1 X79.0 Y3.243
+G1 X79.5 Y3.236
+G1 X80.0 Y3.229
+G1 X80.5 Y3.221
+G1 X81.0 Y3.214
+G1 X81.5 Y3.206
+G1 X82.0 Y3.199
+G1 X82.5 Y3.191
+G1 X83.0 Y3.183
+G1 X83.5 Y3.175
+G1 X84.0 Y3.167
+G1 X84.5 Y3.160
+G1 X85.0 Y3.152
+G1 X85.5 Y3.144
+G1 X86.0 Y3.136
+G1 X86.5 Y3.128
+G1 X87.0 Y3.120
+G1 X87.5 Y3.112
+G1 X88.0 Y3.103
+G1 X88.5 Y3.095
+G1 X89.0 Y3.087
+G1 X89.5 Y3.079
+G1 X90.0 Y3.071
+G1 X90.5 Y3.062
+G1 X91.0 Y3.054
+G1 X91.5 Y3.046
+G1 X92.0 Y3.037
+G1 X92.5 Y3.029
+G1 X93.0 Y3.021
+G1 X93.5 Y3.012
+G1 X94.0 Y3.004
+G1 X94.5 Y2.996
+G1 X95.0 Y2.987
+G1 X95.5 Y2.979
+G1 X96.0 Y2.971
+G1 X96.5 Y2.962
+G1 X97.0 Y2.954
+G1 X97.5 Y2.946
+G1 X98.0 Y2.938
+G1 X98.5 Y2.929
+G1 X99.0 Y2.921
+G1 X99.5 Y2.913
+G1 X100.0 Y2.905
+G1 X100.5 Y2.897
+G1 X101.0 Y2.888
+G1 X101.5 Y2.880
+G1 X102.0 Y2.872
+G1 X102.5 Y2.864
+G1 X103.0 Y2.856
+G1 X103.5 Y2.848
+G1 X104.0 Y2.840
+G1 X104.5 Y2.832
+G1 X105.0 Y2.825
+G1 X105.5 Y2.817
+G1 X106.0 Y2.809
+G1 X106.5 Y2.801
+G1 X107.0 Y2.794
+G1 X107.5 Y2.786
+G1 X108.0 Y2.779
+G1 X108.5 Y2.771
+G1 X109.0 Y2.764
+G1 X109.5 Y2.757
+G1 X110.0 Y2.749
+G1 X110.5 Y2.742
+G1 X111.0 Y2.735
+G1 X111.5 Y2.728
+G1 X112.0 Y2.721
+G1 X112.5 Y2.714
+G1 X113.0 Y2.707
+G1 X113.5 Y2.701
+G1 X114.0 Y2.694
+G1 X114.5 Y2.688
+G1 X115.0 Y2.681
+G1 X115.5 Y2.675
+G1 X116.0 Y2.668
+G1 X116.5 Y2.662
+G1 X117.0 Y2.656
+G1 X117.5 Y2.650
+G1 X118.0 Y2.644
+G1 X118.5 Y2.638
+G1 X119.0 Y2.633
+G1 X119.5 Y2.627
+G1 X120.0 Y2.622
+G1 X120.5 Y2.616
+G1 X121.0 Y2.611
+G1 X121.5 Y2.606
+G1 X122.0 Y2.601
+G1 X122.5 Y2.596
+G1 X123.0 Y2.591
+G1 X123.5 Y2.586
+G1 X124.0 Y2.582
+G1 X124.5 Y2.577
+G1 X125.0 Y2.573
+G1 X125.5 Y2.568
+G1 X126.0 Y2.564
+G1 X126.5 Y2.560
+G1 X127.0 Y2.556
+G1 X127.5 Y2.553
+G1 X128.0 Y2.549
+G1 X128.5 Y2.545
+G1 X129.0 Y2.542
+G1 X129.5 Y2.539
+G1 X130.0 Y2.535
+G1 X130.5 Y2.532
+G1 X131.0 Y2.530
+G1 X131.5 Y2.527
+G1 X132.0 Y2.524
+G1 X132.5 Y2.522
+G1 X133.0 Y2.519
+G1 X133.5 Y2.517
+G1 X134.0 Y2.515
+G1 X134.5 Y2.513
+G1 X135.0 Y2.511
+G1 X135.5 Y2.510
+G1 X136.0 Y2.508
+G1 X136.5 Y2.507
+G1 X137.0 Y2.505
+G1 X137.5 Y2.504
+G1 X138.0 Y2.503
+G1 X138.5 Y2.502
+G1 X139.0 Y2.502
+G1 X139.5 Y2.501
+G1 X140.0 Y2.501
+G1 X140.5 Y2.500
+G1 X141.0 Y2.500
+G1 X141.5 Y2.500
+G1 X142.0 Y2.500
+G1 X142.5 Y2.500
+G1 X143.0 Y2.501
+G1 X143.5 Y2.501
+G1 X144.0 Y2.502
+G1 X144.5 Y2.503
+G1 X145.0 Y2.504
+G1 X145.5 Y2.505
+G1 X146.0 Y2.506
+G1 X146.5 Y2.507
+G1 X147.0 Y2.509
+G1 X147.5 Y2.510
+G1 X148.0 Y2.512
+G1 X148.5 Y2.514
+G1 X149.0 Y2.516
+G1 X149.5 Y2.518
+G1 X150.0 Y2.521
+G1 X150.5 Y2.523
+G1 X151.0 Y2.526
+G1 X151.5 Y2.528
+G1 X152.0 Y2.531
+G1 X152.5 Y2.534
+G1 X153.0 Y2.537
+G1 X153.5 Y2.540
+G1 X154.0 Y2.544
+G1 X154.5 Y2.547
+G1 X155.0 Y2.551
+G1 X155.5 Y2.554
+G1 X156.0 Y2.558
+G1 X156.5 Y2.562
+G1 X157.0 Y2.566
+G1 X157.5 Y2.571
+G1 X158.0 Y2.575
+G1 X158.5 Y2.579
+G1 X159.0 Y2.584
+G1 X159.5 Y2.589
+G1 X160.0 Y2.593
+G1 X160.5 Y2.598
+G1 X161.0 Y2.603
+G1 X161.5 Y2.608
+G1 X162.0 Y2.614
+G1 X162.5 Y2.619
+G1 X163.0 Y2.624
+G1 X163.5 Y2.630
+G1 X164.0 Y2.636
+G1 X164.5 Y2.641
+G1 X165.0 Y2.647
+G1 X165.5 Y2.653
+G1 X166.0 Y2.659
+G1 X166.5 Y2.665
+G1 X167.0 Y2.672
+G1 X167.5 Y2.678
+G1 X168.0 Y2.684
+G1 X168.5 Y2.691
+G1 X169.0 Y2.697
+G1 X169.5 Y2.704
+G1 X170.0 Y2.711
+G1 X170.5 Y2.718
+G1 X171.0 Y2.725
+G1 X171.5 Y2.732
+G1 X172.0 Y2.739
+G1 X172.5 Y2.746
+G1 X173.0 Y2.753
+G1 X173.5 Y2.760
+G1 X174.0 Y2.768
+G1 X174.5 Y2.775
+G1 X175.0 Y2.783
+G1 X175.5 Y2.790
+G1 X176.0 Y2.798
+G1 X176.5 Y2.805
+G1 X177.0 Y2.813
+G1 X177.5 Y2.821
+G1 X178.0 Y2.829
+G1 X178.5 Y2.836
+G1 X179.0 Y2.844
+G1 X179.5 Y2.852
+G1 X180.0 Y2.860
+G1 X180.5 Y2.868
+G1 X181.0 Y2.876
+G1 X181.5 Y2.884
+G1 X182.0 Y2.893
+G1 X182.5 Y2.901
+G1 X183.0 Y2.909
+G1 X183.5 Y2.917
+G1 X184.0 Y2.925
+G1 X184.5 Y2.934
+G1 X185.0 Y2.942
+G1 X185.5 Y2.950
+G1 X186.0 Y2.958
+G1 X186.5 Y2.967
+G1 X187.0 Y2.975
+G1 X187.5 Y2.983
+G1 X188.0 Y2.992
+G1 X188.5 Y3.000
+G1 X189.0 Y3.008
+G1 X189.5 Y3.017
+G1 X190.0 Y3.025
+G1 X190.5 Y3.033
+G1 X191.0 Y3.042
+G1 X191.5 Y3.050
+G1 X192.0 Y3.058
+G1 X192.5 Y3.067
+G1 X193.0 Y3.075
+G1 X193.5 Y3.083
+G1 X194.0 Y3.091
+G1 X194.5 Y3.099
+G1 X195.0 Y3.108
+G1 X195.5 Y3.116
+G1 X196.0 Y3.124
+G1 X196.5 Y3.132
+G1 X197.0 Y3.140
+G1 X197.5 Y3.148
+G1 X198.0 Y3.156
+G1 X198.5 Y3.164
+G1 X199.0 Y3.172
+G1 X199.5 Y3.179
+G1 X200.0 Y3.187
+G1 X200.0 Y4.187
+G1 X199.5 Y4.179
+G1 X199.0 Y4.172
+G1 X198.5 Y4.164
+G1 X198.0 Y4.156
+G1 X197.5 Y4.148
+G1 X197.0 Y4.140
+G1 X196.5 Y4.132
+G1 X196.0 Y4.124
+G1 X195.5 Y4.116
+G1 X195.0 Y4.108
+G1 X194.5 Y4.099
+G1 X194.0 Y4.091
+G1 X193.5 Y4.083
+G1 X193.0 Y4.075
+G1 X192.5 Y4.067
+G1 X192.0 Y4.058
+G1 X191.5 Y4.050
+G1 X191.0 Y4.042
+G1 X190.5 Y4.033
+G1 X190.0 Y4.025
+G1 X189.5 Y4.017
+G1 X189.0 Y4.008
+G1 X188.5 Y4.000
+G1 X188.0 Y3.992
+G1 X187.5 Y3.983
+G1 X187.0 Y3.975
+G1 X186.5 Y3.967
+G1 X186.0 Y3.958
+G1 X185.5 Y3.950
+G1 X185.0 Y3.942
+G1 X184.5 Y3.934
+G1 X184.0 Y3.925
+G1 X183.5 Y3.917
+G1 X183.0 Y3.909
+G1 X182.5 Y3.901
+G1 X182.0 Y3.893
+G1 X181.5 Y3.884
+G1 X181.0 Y3.876
+G1 X180.5 Y3.868
+G1 X180.0 Y3.860
+G1 X179.5 Y3.852
+G1 X179.0 Y3.844
+G1 X178.5 Y3.836
+G1 X178.0 Y3.829
+G1 X177.5 Y3.821
+G1 X177.0 Y3.813
+G1 X176.5 Y3.805
+G1 X176.0 Y3.798
+G1 X175.5 Y3.790
+G1 X175.0 Y3.783
+G1 X174.5 Y3.775
+G1 X174.0 Y3.768
+G1 X173.5 Y3.760
+G1 X173.0 Y3.753
+G1 X172.5 Y3.746
+G1 X172.0 Y3.739
+G1 X171.5 Y3.732
+G1 X171.0 Y3.725
+G1 X170.5 Y3.718
+G1 X170.0 Y3.711
+G1 X169.5 Y3.704
+G1 X169.0 Y3.697
+G1 X168.5 Y3.691
+G1 X168.0 Y3.684
+G1 X167.5 Y3.678
+G1 X167.0 Y3.672
+G1 X166.5 Y3.665
+G1 X166.0 Y3.659
+G1 X165.5 Y3.653
+G1 X165.0 Y3.647
+G1 X164.5 Y3.641
+G1 X164.0 Y3.636
+G1 X163.5 Y3.630
+G1 X163.0 Y3.624
+G1 X162.5 Y3.619
+G1 X162.0 Y3.614
+G1 X161.5 Y3.608
+G1 X161.0 Y3.603
+G1 X160.5 Y3.598
+G1 X160.0 Y3.593
+G1 X159.5 Y3.589
+G1 X159.0 Y3.584
+G1 X158.5 Y3.579
+G1 X158.0 Y3.575
+G1 X157.5 Y3.571
+G1 X157.0 Y3.566
+G1 X156.5 Y3.562
+G1 X156.0 Y3.558
+G1 X155.5 Y3.554
+G1 X155.0 Y3.551
+G1 X154.5 Y3.547
+G1 X154.0 Y3.544
+G1 X153.5 Y3.540
+G1 X153.0 Y3.537
+G1 X152.5 Y3.534
+G1 X152.0 Y3.531
+G1 X151.5 Y3.528
+G1 X151.0 Y3.526
+G1 X150.5 Y3.523
+G1 X150.0 Y3.521
+G1 X149.5 Y3.518
+G1 X149.0 Y3.516
+G1 X148.5 Y3.514
+G1 X148.0 Y3.512
+G1 X147.5 Y3.510
+G1 X147.0 Y3.509
+G1 X146.5 Y3.507
+G1 X146.0 Y3.506
+G1 X145.5 Y3.505
+G1 X145.0 Y3.504
+G1 X144.5 Y3.503
+G1 X144.0 Y3.502
+G1 X143.5 Y3.501
+G1 X143.0 Y3.501
+G1 X142.5 Y3.500
+G1 X142.0 Y3.500
+G1 X141.5 Y3.500
+G1 X141.0 Y3.500
+G1 X140.5 Y3.500
+G1 X140.0 Y3.501
+G1 X139.5 Y3.501
+G1 X139.0 Y3.502
+G1 X138.5 Y3.502
+G1 X138.0 Y3.503
+G1 X137.5 Y3.504
+G1 X137.0 Y3.505
+G1 X136.5 Y3.507
+G1 X136.0 Y3.508
+G1 X135.5 Y3.510
+G1 X135.0 Y3.511
+G1 X134.5 Y3.513
+G1 X134.0 Y3.515
+G1 X133.5 Y3.517
+G1 X133.0 Y3.519
+G1 X132.5 Y3.522
+G1 X132.0 Y3.524
+G1 X131.5 Y3.527
+G1 X131.0 Y3.530
+G1 X130.5 Y3.532
+G1 X130.0 Y3.535
+G1 X129.5 Y3.539
+G1 X129.0 Y3.542
+G1 X128.5 Y3.545
+G1 X128.0 Y3.549
+G1 X127.5 Y3.553
+G1 X127.0 Y3.556
+G1 X126.5 Y3.560
+G1 X126.0 Y3.564
+G1 X125.5 Y3.568
+G1 X125.0 Y3.573
+G1 X124.5 Y3.577
+G1 X124.0 Y3.582
+G1 X123.5 Y3.586
+G1 X123.0 Y3.591
+G1 X122.5 Y3.596
+G1 X122.0 Y3.601
+G1 X121.5 Y3.606
+G1 X121.0 Y3.611
+G1 X120.5 Y3.616
+G1 X120.0 Y3.622
+G1 X119.5 Y3.627
+G1 X119.0 Y3.633
+G1 X118.5 Y3.638
+G1 X118.0 Y3.644
+G1 X117.5 Y3.650
+G1 X117.0 Y3.656
+G1 X116.5 Y3.662
+G1 X116.0 Y3.668
+G1 X115.5 Y3.675
+G1 X115.0 Y3.681
+G1 X114.5 Y3.688
+G1 X114.0 Y3.694
+G1 X113.5 Y3.701
+G1 X113.0 Y3.707
+G1 X112.5 Y3.714
+G1 X112.0 Y3.721
+G1 X111.5 Y3.728
+G1 X111.0 Y3.735
+G1 X110.5 Y3.742
+G1 X110.0 Y3.749
+G1 X109.5 Y3.757
+G1 X109.0 Y3.764
+G1 X108.5 Y3.771
+G1 X108.0 Y3.779
+G1 X107.5 Y3.786
+G1 X107.0 Y3.794
+G1 X106.5 Y3.801
+G1 X106.0 Y3.809
+G1 X105.5 Y3.817
+G1 X105.0 Y3.825
+G1 X104.5 Y3.832
+G1 X104.0 Y3.840
+G1 X103.5 Y3.848
+G1 X103.0 Y3.856
+G1 X102.5 Y3.864
+G1 X102.0 Y3.872
+G1 X101.5 Y3.880
+G1 X101.0 Y3.888
+G1 X100.5 Y3.897
+G1 X100.0 Y3.905
+G1 X99.5 Y3.913
+G1 X99.0 Y3.921
+G1 X98.5 Y3.929
+G1 X98.0 Y3.938
+G1 X97.5 Y3.946
+G1 X97.0 Y3.954
+G1 X96.5 Y3.962
+G1 X96.0 Y3.971
+G1 X95.5 Y3.979
+G1 X95.0 Y3.987
+G1 X94.5 Y3.996
+G1 X94.0 Y4.004
+G1 X93.5 Y4.012
+G1 X93.0 Y4.021
+G1 X92.5 Y4.029
+G1 X92.0 Y4.037
+G1 X91.5 Y4.046
+G1 X91.0 Y4.054
+G1 X90.5 Y4.062
+G1 X90.0 Y4.071
+G1 X89.5 Y4.079
+G1 X89.0 Y4.087
+G1 X88.5 Y4.095
+G1 X88.0 Y4.103
+G1 X87.5 Y4.112
+G1 X87.0 Y4.120
+G1 X86.5 Y4.128
+G1 X86.0 Y4.136
+G1 X85.5 Y4.144
+G1 X85.0 Y4.152
+G1 X84.5 Y4.160
+G1 X84.0 Y4.167
+G1 X83.5 Y4.175
+G1 X83.0 Y4.183
+G1 X82.5 Y4.191
+G1 X82.0 Y4.199
+G1 X81.5 Y4.206
+G1 X81.0 Y4.214
+G1 X80.5 Y4.221
+G1 X80.0 Y4.229
+G1 X79.5 Y4.236
+G1 X79.0 Y4.243
+G1 X78.5 Y4.251
+G1 X78.0 Y4.258
+G1 X77.5 Y4.265
+G1 X77.0 Y4.272
+G1 X76.5 Y4.279
+G1 X76.0 Y4.286
+G1 X75.5 Y4.293
+G1 X75.0 Y4.299
+G1 X74.5 Y4.306
+G1 X74.0 Y4.312
+G1 X73.5 Y4.319
+G1 X73.0 Y4.325
+G1 X72.5 Y4.332
+G1 X72.0 Y4.338
+G1 X71.5 Y4.344
+G1 X71.0 Y4.350
+G1 X70.5 Y4.356
+G1 X70.0 Y4.362
+G1 X69.5 Y4.367
+G1 X69.0 Y4.373
+G1 X68.5 Y4.378
+G1 X68.0 Y4.384
+G1 X67.5 Y4.389
+G1 X67.0 Y4.394
+G1 X66.5 Y4.399
+G1 X66.0 Y4.404
+G1 X65.5 Y4.409
+G1 X65.0 Y4.414
+G1 X64.5 Y4.418
+G1 X64.0 Y4.423
+G1 X63.5 Y4.427
+G1 X63.0 Y4.432
+G1 X62.5 Y4.436
+G1 X62.0 Y4.440
+G1 X61.5 Y4.444
+G1 X61.0 Y4.447
+G1 X60.5 Y4.451
+G1 X60.0 Y4.455
+G1 X59.5 Y4.458
+G1 X59.0 Y4.461
+G1 X58.5 Y4.464
+G1 X58.0 Y4.468
+G1 X57.5 Y4.470
+G1 X57.0 Y4.473
+G1 X56.5 Y4.476
+G1 X56.0 Y4.478
+G1 X55.5 Y4.481
+G1 X55.0 Y4.483
+G1 X54.5 Y4.485
+G1 X54.0 Y4.487
+G1 X53.5 Y4.489
+G1 X53.0 Y4.490
+G1 X52.5 Y4.492
+G1 X52.0 Y4.493
+G1 X51.5 Y4.495
+G1 X51.0 Y4.496
+G1 X50.5 Y4.497
+G1 X50.0 Y4.498
+G1 X49.5 Y4.498
+G1 X49.0 Y4.499
+G1 X48.5 Y4.499
+G1 X48.0 Y4.500
+G1 X47.5 Y4.500
+G1 X47.0 Y4.500
+G1 X46.5 Y4.500
+G1 X46.0 Y4.500
+G1 X45.5 Y4.499
+G1 X45.0 Y4.499
+G1 X44.5 Y4.498
+G1 X44.0 Y4.497
+G1 X43.5 Y4.496
+G1 X43.0 Y4.495
+G1 X42.5 Y4.494
+G1 X42.0 Y4.493
+G1 X41.5 Y4.491
+G1 X41.0 Y4.490
+G1 X40.5 Y4.488
+G1 X40.0 Y4.486
+G1 X39.5 Y4.484
+G1 X39.0 Y4.482
+G1 X38.5 Y4.479
+G1 X38.0 Y4.477
+G1 X37.5 Y4.474
+G1 X37.0 Y4.472
+G1 X36.5 Y4.469
+G1 X36.0 Y4.466
+G1 X35.5 Y4.463
+G1 X35.0 Y4.460
+G1 X34.5 Y4.456
+G1 X34.0 Y4.453
+G1 X33.5 Y4.449
+G1 X33.0 Y4.446
+G1 X32.5 Y4.442
+G1 X32.0 Y4.438
+G1 X31.5 Y4.434
+G1 X31.0 Y4.430
+G1 X30.5 Y4.425
+G1 X30.0 Y4.421
+G1 X29.5 Y4.416
+G1 X29.0 Y4.411
+G1 X28.5 Y4.407
+G1 X28.0 Y4.402
+G1 X27.5 Y4.397
+G1 X27.0 Y4.392
+G1 X26.5 Y4.386
+G1 X26.0 Y4.381
+G1 X25.5 Y4.376
+G1 X25.0 Y4.370
+G1 X24.5 Y4.364
+G1 X24.0 Y4.359
+G1 X23.5 Y4.353
+G1 X23.0 Y4.347
+G1 X22.5 Y4.341
+G1 X22.0 Y4.335
+G1 X21.5 Y4.328
+G1 X21.0 Y4.322
+G1 X20.5 Y4.316
+G1 X20.0 Y4.309
+G1 X19.5 Y4.303
+G1 X19.0 Y4.296
+G1 X18.5 Y4.289
+G1 X18.0 Y4.282
+G1 X17.5 Y4.275
+G1 X17.0 Y4.268
+G1 X16.5 Y4.261
+G1 X16.0 Y4.254
+G1 X15.5 Y4.247
+G1 X15.0 Y4.240
+G1 X14.5 Y4.232
+G1 X14.0 Y4.225
+G1 X13.5 Y4.217
+G1 X13.0 Y4.210
+G1 X12.5 Y4.202
+G1 X12.0 Y4.195
+G1 X11.5 Y4.187
+G1 X11.0 Y4.179
+G1 X10.5 Y4.171
+G1 X10.0 Y4.164
+G1 X9.5 Y4.156
+G1 X9.0 Y4.148
+G1 X8.5 Y4.140
+G1 X8.0 Y4.132
+G1 X7.5 Y4.124
+G1 X7.0 Y4.116
+G1 X6.5 Y4.107
+G1 X6.0 Y4.099
+G1 X5.5 Y4.091
+G1 X5.0 Y4.083
+G1 X4.5 Y4.075
+G1 X4.0 Y4.066
+G1 X3.5 Y4.058
+G1 X3.0 Y4.050
+G1 X2.5 Y4.042
+G1 X2.0 Y4.033
+G1 X1.5 Y4.025
+G1 X1.0 Y4.017
+G1 X0.5 Y4.008
+G1 X0.0 Y4.000
+G0 X0 Y0
+G4 P0.01
+$P
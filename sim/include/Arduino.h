@@ -0,0 +1,84 @@
+/*
+    Arduino.h - host simulation shim of the Arduino-ESP32 core used by Grbl_Esp32
+    Part of the Grbl_Esp32 host simulation, see sim/sim_hal.h.
+*/
+
+#ifndef sim_Arduino_h
+#define sim_Arduino_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdarg.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "binary.h"
+
+#define IRAM_ATTR
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x02
+#define INPUT_PULLUP 0x05
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+int64_t esp_timer_get_time();
+uint32_t xthal_get_ccount();
+
+// The simulation has no PSRAM, so allocations fall back to the internal heap like on boards without it.
+void *ps_malloc(size_t size);
+
+class HardwareSerial
+{
+    public:
+        void begin(unsigned long baud);
+        int available();
+        int read();
+        size_t write(uint8_t c);
+        size_t write(const uint8_t *buffer, size_t size);
+        size_t print(const char *text);
+        size_t print(char c);
+        size_t print(int n);
+        size_t print(double n, int digits = 2);
+        size_t println(const char *text);
+        size_t println(struct tm *timeinfo, const char *format);
+        size_t printf(const char *format, ...);
+        void flush();
+};
+extern HardwareSerial Serial;
+
+class EspClass
+{
+    public:
+        uint32_t getCpuFreqMHz();
+};
+extern EspClass ESP;
+
+#endif
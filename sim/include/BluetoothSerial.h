@@ -0,0 +1,39 @@
+/*
+    BluetoothSerial.h - host simulation shim of the Arduino-ESP32 Bluetooth serial port
+    Part of the Grbl_Esp32 host simulation. Never has a client, so all traffic uses Serial.
+*/
+
+#ifndef sim_BluetoothSerial_h
+#define sim_BluetoothSerial_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Subset of esp_spp_api.h
+typedef enum
+{
+    ESP_SPP_DATA_IND_EVT = 30,
+} esp_spp_cb_event_t;
+typedef union
+{
+    struct
+    {
+        uint16_t len;
+        uint8_t *data;
+    } data_ind;
+} esp_spp_cb_param_t;
+typedef void (esp_spp_cb_t)(esp_spp_cb_event_t event, esp_spp_cb_param_t *param);
+
+class BluetoothSerial
+{
+    public:
+        bool begin(const char *name) { return (true); }
+        int register_callback(esp_spp_cb_t *callback) { return (0); }
+        bool hasClient() { return (false); }
+        int available() { return (0); }
+        int read() { return (-1); }
+        size_t print(const char *text) { return (0); }
+        size_t write(const uint8_t *buffer, size_t size) { return (0); }
+};
+
+#endif
@@ -0,0 +1,23 @@
+/*
+    EEPROM.h - host simulation shim of the Arduino-ESP32 EEPROM emulation
+    Part of the Grbl_Esp32 host simulation. Backed by RAM, optionally loaded from and
+    committed to a file, see sim/sim_main.cpp.
+*/
+
+#ifndef sim_EEPROM_h
+#define sim_EEPROM_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+class EEPROMClass
+{
+    public:
+        bool begin(size_t size);
+        uint8_t read(int address);
+        void write(int address, uint8_t value);
+        bool commit();
+};
+extern EEPROMClass EEPROM;
+
+#endif
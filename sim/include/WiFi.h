@@ -0,0 +1,27 @@
+/*
+    WiFi.h - host simulation shim of the Arduino-ESP32 WiFi and time functions used by ntc.cpp
+    Part of the Grbl_Esp32 host simulation. Always connected. Local time is the host clock.
+*/
+
+#ifndef sim_WiFi_h
+#define sim_WiFi_h
+
+#include <time.h>
+
+#define WL_CONNECTED 3
+#define WIFI_OFF 0
+
+class WiFiClass
+{
+    public:
+        void begin(const char *ssid, const char *password);
+        int status();
+        bool disconnect(bool wifi_off);
+        bool mode(int mode);
+};
+extern WiFiClass WiFi;
+
+void configTime(long gmt_offset_sec, int daylight_offset_sec, const char *server);
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+
+#endif
@@ -0,0 +1,105 @@
+/*
+    rmt.h - host simulation shim of the ESP-IDF RMT transmitter driver and registers
+    Part of the Grbl_Esp32 host simulation. A tx_start written to a channel configuration
+    register plays the channel items onto its pin in virtual time, see sim/sim_hal.cpp.
+*/
+
+#ifndef sim_rmt_h
+#define sim_rmt_h
+
+#include <stdint.h>
+#include "Arduino.h"
+
+typedef enum
+{
+    RMT_CHANNEL_0 = 0, RMT_CHANNEL_1, RMT_CHANNEL_2, RMT_CHANNEL_3,
+    RMT_CHANNEL_4, RMT_CHANNEL_5, RMT_CHANNEL_6, RMT_CHANNEL_7,
+    RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef enum
+{
+    RMT_MODE_TX = 0,
+    RMT_MODE_RX,
+    RMT_MODE_MAX
+} rmt_mode_t;
+
+typedef enum
+{
+    RMT_IDLE_LEVEL_LOW = 0,
+    RMT_IDLE_LEVEL_HIGH,
+    RMT_IDLE_LEVEL_MAX
+} rmt_idle_level_t;
+
+typedef enum
+{
+    RMT_CARRIER_LEVEL_LOW = 0,
+    RMT_CARRIER_LEVEL_HIGH,
+    RMT_CARRIER_LEVEL_MAX
+} rmt_carrier_level_t;
+
+typedef struct
+{
+    bool loop_en;
+    uint32_t carrier_freq_hz;
+    uint8_t carrier_duty_percent;
+    rmt_carrier_level_t carrier_level;
+    bool carrier_en;
+    rmt_idle_level_t idle_level;
+    bool idle_output_en;
+} rmt_tx_config_t;
+
+typedef struct
+{
+    rmt_mode_t rmt_mode;
+    rmt_channel_t channel;
+    uint8_t clk_div;
+    gpio_num_t gpio_num;
+    uint8_t mem_block_num;
+    rmt_tx_config_t tx_config;
+} rmt_config_t;
+
+typedef struct
+{
+    union
+    {
+        struct
+        {
+            uint32_t duration0: 15;
+            uint32_t level0: 1;
+            uint32_t duration1: 15;
+            uint32_t level1: 1;
+        };
+        uint32_t val;
+    };
+} rmt_item32_t;
+
+typedef volatile struct rmt_dev_s
+{
+    struct
+    {
+        struct
+        {
+            uint32_t tx_start: 1;
+            uint32_t rx_en: 1;
+            uint32_t mem_wr_rst: 1;
+            uint32_t mem_rd_rst: 1;
+            uint32_t apb_mem_rst: 1;
+            uint32_t mem_owner: 1;
+            uint32_t tx_conti_mode: 1;
+            uint32_t rx_filter_en: 1;
+            uint32_t rx_filter_thres: 8;
+            uint32_t ref_cnt_rst: 1;
+            uint32_t ref_always_on: 1;
+            uint32_t idle_out_lv: 1;
+            uint32_t idle_out_en: 1;
+            uint32_t reserved20: 12;
+        } conf1;
+    } conf_ch[8];
+} rmt_dev_t;
+extern rmt_dev_t RMT;
+
+esp_err_t rmt_config(const rmt_config_t *rmt_param);
+esp_err_t rmt_fill_tx_items(rmt_channel_t channel, const rmt_item32_t *item, uint16_t item_num, uint16_t mem_offset);
+
+#endif
@@ -0,0 +1,112 @@
+/*
+    timer.h - host simulation shim of the ESP-IDF general purpose timer driver and registers
+    Part of the Grbl_Esp32 host simulation. Only timer group 0 exists. Its timers count virtual
+    time and fire their registered handlers from the virtual timer thread, see sim/sim_hal.cpp.
+    Register writes made by the handlers are applied when the handler returns.
+*/
+
+#ifndef sim_timer_h
+#define sim_timer_h
+
+#include <stdint.h>
+#include "Arduino.h"
+
+typedef enum
+{
+    TIMER_GROUP_0 = 0,
+    TIMER_GROUP_MAX
+} timer_group_t;
+
+typedef enum
+{
+    TIMER_0 = 0,
+    TIMER_1 = 1,
+    TIMER_MAX
+} timer_idx_t;
+
+typedef enum
+{
+    TIMER_COUNT_DOWN = 0,
+    TIMER_COUNT_UP = 1
+} timer_count_dir_t;
+
+typedef enum
+{
+    TIMER_PAUSE = 0,
+    TIMER_START = 1
+} timer_start_t;
+
+typedef enum
+{
+    TIMER_ALARM_DIS = 0,
+    TIMER_ALARM_EN = 1
+} timer_alarm_t;
+
+typedef enum
+{
+    TIMER_INTR_LEVEL = 0,
+    TIMER_INTR_EDGE = 1
+} timer_intr_mode_t;
+
+typedef enum
+{
+    TIMER_AUTORELOAD_DIS = 0,
+    TIMER_AUTORELOAD_EN = 1
+} timer_autoreload_t;
+
+typedef struct
+{
+    timer_alarm_t alarm_en;
+    timer_start_t counter_en;
+    timer_intr_mode_t intr_type;
+    timer_count_dir_t counter_dir;
+    bool auto_reload;
+    uint32_t divider;
+} timer_config_t;
+
+typedef volatile struct timg_hwtimer_reg_s
+{
+    struct
+    {
+        uint32_t reserved0: 10;
+        uint32_t alarm_en: 1;
+        uint32_t level_int_en: 1;
+        uint32_t edge_int_en: 1;
+        uint32_t divider: 16;
+        uint32_t autoreload: 1;
+        uint32_t increase: 1;
+        uint32_t enable: 1;
+    } config;
+    uint32_t cnt_low;
+    uint32_t cnt_high;
+    uint32_t update;
+    uint32_t alarm_low;
+    uint32_t alarm_high;
+    uint32_t load_low;
+    uint32_t load_high;
+    uint32_t reload;
+} timg_hwtimer_reg_t;
+
+typedef volatile struct timg_dev_s
+{
+    timg_hwtimer_reg_t hw_timer[2];
+    struct
+    {
+        uint32_t t0: 1;
+        uint32_t t1: 1;
+        uint32_t wdt: 1;
+        uint32_t reserved3: 29;
+    } int_clr_timers;
+} timg_dev_t;
+extern timg_dev_t TIMERG0;
+
+esp_err_t timer_init(timer_group_t group_num, timer_idx_t timer_num, const timer_config_t *config);
+esp_err_t timer_set_counter_value(timer_group_t group_num, timer_idx_t timer_num, uint64_t load_val);
+esp_err_t timer_set_alarm_value(timer_group_t group_num, timer_idx_t timer_num, uint64_t alarm_value);
+esp_err_t timer_start(timer_group_t group_num, timer_idx_t timer_num);
+esp_err_t timer_pause(timer_group_t group_num, timer_idx_t timer_num);
+esp_err_t timer_enable_intr(timer_group_t group_num, timer_idx_t timer_num);
+esp_err_t timer_isr_register(timer_group_t group_num, timer_idx_t timer_num, void (*fn)(void *), void *arg,
+                             int intr_alloc_flags, void *handle);
+
+#endif
@@ -0,0 +1,80 @@
+/*
+    uart.h - host simulation shim of the ESP-IDF UART driver
+    Part of the Grbl_Esp32 host simulation. UART0 reads the simulation input and writes to stdout,
+    like Serial, see sim/sim_arduino.cpp. Its event queue holds an UART_DATA event while there is
+    input to read.
+*/
+
+#ifndef sim_uart_h
+#define sim_uart_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+typedef enum
+{
+    UART_NUM_0 = 0,
+    UART_NUM_MAX
+} uart_port_t;
+
+typedef enum
+{
+    UART_DATA_8_BITS = 0x3,
+} uart_word_length_t;
+
+typedef enum
+{
+    UART_PARITY_DISABLE = 0x0,
+} uart_parity_t;
+
+typedef enum
+{
+    UART_STOP_BITS_1 = 0x1,
+} uart_stop_bits_t;
+
+typedef enum
+{
+    UART_HW_FLOWCTRL_DISABLE = 0x0,
+} uart_hw_flowcontrol_t;
+
+typedef struct
+{
+    int baud_rate;
+    uart_word_length_t data_bits;
+    uart_parity_t parity;
+    uart_stop_bits_t stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uint8_t rx_flow_ctrl_thresh;
+} uart_config_t;
+
+typedef enum
+{
+    UART_DATA,
+    UART_BREAK,
+    UART_BUFFER_FULL,
+    UART_FIFO_OVF,
+    UART_FRAME_ERR,
+    UART_PARITY_ERR,
+    UART_DATA_BREAK,
+    UART_PATTERN_DET,
+    UART_EVENT_MAX,
+} uart_event_type_t;
+
+typedef struct
+{
+    uart_event_type_t type;
+    size_t size;
+} uart_event_t;
+
+esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t *uart_config);
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size, int queue_size,
+                              QueueHandle_t *uart_queue, int intr_alloc_flags);
+int uart_read_bytes(uart_port_t uart_num, uint8_t *buf, uint32_t length, TickType_t ticks_to_wait);
+int uart_write_bytes(uart_port_t uart_num, const char *src, size_t size);
+
+#endif
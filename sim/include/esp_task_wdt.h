@@ -0,0 +1,3 @@
+/*
+    esp_task_wdt.h - host simulation shim. The task watchdog is not simulated.
+*/
@@ -0,0 +1,42 @@
+/*
+    FreeRTOS.h - host simulation shim of the FreeRTOS types and critical sections used by Grbl_Esp32
+    Part of the Grbl_Esp32 host simulation. Critical sections take the simulated interrupt lock,
+    which the virtual timer thread holds while running an interrupt handler. See sim/sim_hal.h.
+*/
+
+#ifndef sim_FreeRTOS_h
+#define sim_FreeRTOS_h
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdPASS  pdTRUE
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_RATE_MS ((TickType_t)1)
+#define portTICK_PERIOD_MS portTICK_RATE_MS
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+typedef struct
+{
+    uint32_t owner;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+void vTaskEnterCritical(portMUX_TYPE *mux);
+void vTaskExitCritical(portMUX_TYPE *mux);
+#define portENTER_CRITICAL(mux) vTaskEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) vTaskExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vTaskEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) vTaskExitCritical(mux)
+
+#define portYIELD_FROM_ISR()
+
+BaseType_t xPortGetCoreID();
+
+#endif
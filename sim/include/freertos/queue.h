@@ -0,0 +1,16 @@
+/*
+    queue.h - host simulation shim of the FreeRTOS queue API used by Grbl_Esp32
+    Part of the Grbl_Esp32 host simulation. The only queue is the event queue of the UART driver,
+    see driver/uart.h.
+*/
+
+#ifndef sim_queue_h
+#define sim_queue_h
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_queue *QueueHandle_t;
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait);
+
+#endif
@@ -0,0 +1,20 @@
+/*
+    semphr.h - host simulation shim of the FreeRTOS recursive mutex and binary semaphore API used by Grbl_Esp32
+    Part of the Grbl_Esp32 host simulation.
+*/
+
+#ifndef sim_semphr_h
+#define sim_semphr_h
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_mutex *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex);
+SemaphoreHandle_t xSemaphoreCreateBinary();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+#endif
@@ -0,0 +1,23 @@
+/*
+    task.h - host simulation shim of the FreeRTOS task API used by Grbl_Esp32
+    Part of the Grbl_Esp32 host simulation. Tasks run as host threads. Priorities and core
+    affinity are ignored.
+*/
+
+#ifndef sim_task_h
+#define sim_task_h
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack_depth,
+                                   void *parameters, UBaseType_t priority, TaskHandle_t *created_task,
+                                   BaseType_t core_id);
+void vTaskDelay(TickType_t ticks);
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken);
+
+#endif
@@ -0,0 +1,41 @@
+/*
+    gpio_struct.h - host simulation shim of the ESP32 GPIO output set/clear registers
+    Part of the Grbl_Esp32 host simulation. Writes go straight to the simulated pins, so the
+    step/direction trace gets the exact virtual time of each register write.
+*/
+
+#ifndef sim_gpio_struct_h
+#define sim_gpio_struct_h
+
+#include <stdint.h>
+
+void sim_gpio_write_mask(uint8_t bank, bool set, uint32_t mask);
+
+// A write-1-to-set or write-1-to-clear register of one GPIO bank. GPIO0-31 or GPIO32-39.
+struct sim_gpio_w1_reg_t
+{
+    uint8_t bank;
+    bool set;
+    sim_gpio_w1_reg_t &operator=(uint32_t mask)
+    {
+        sim_gpio_write_mask(bank, set, mask);
+        return (*this);
+    }
+};
+
+typedef struct
+{
+    sim_gpio_w1_reg_t out_w1ts;
+    sim_gpio_w1_reg_t out_w1tc;
+    struct
+    {
+        sim_gpio_w1_reg_t val;
+    } out1_w1ts;
+    struct
+    {
+        sim_gpio_w1_reg_t val;
+    } out1_w1tc;
+} gpio_dev_t;
+extern gpio_dev_t GPIO;
+
+#endif
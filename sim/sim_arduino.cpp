@@ -0,0 +1,602 @@
+/*
+    sim_arduino.cpp - Arduino-ESP32 core functions, serial port, EEPROM and WiFi of the host simulation
+    Part of the Grbl_Esp32 host simulation, see sim_hal.h
+*/
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "WiFi.h"
+#include "esp_partition.h"
+#include "grbl.h"
+#include "sim_hal.h"
+
+#define SIM_EEPROM_SIZE 4096
+#define SIM_CPU_FREQ_MHZ 240
+
+HardwareSerial Serial;
+EspClass ESP;
+EEPROMClass EEPROM;
+WiFiClass WiFi;
+
+
+// ================================ Time ================================
+
+unsigned long millis()
+{
+    return ((unsigned long)(sim_ticks() / (SIM_TICKS_PER_MICROSECOND * 1000)));
+}
+
+unsigned long micros()
+{
+    return ((unsigned long)(sim_ticks() / SIM_TICKS_PER_MICROSECOND));
+}
+
+int64_t esp_timer_get_time()
+{
+    return ((int64_t)(sim_ticks() / SIM_TICKS_PER_MICROSECOND));
+}
+
+void delay(uint32_t ms)
+{
+    sim_sleep_us((uint64_t)ms * 1000);
+}
+
+// Cycle counts measure host execution time, so profiles show the cost of the host build.
+uint32_t xthal_get_ccount()
+{
+    auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+    return ((uint32_t)(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() * SIM_CPU_FREQ_MHZ / 1000));
+}
+
+void *ps_malloc(size_t size)
+{
+    return (NULL);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return ((x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min);
+}
+
+uint32_t EspClass::getCpuFreqMHz()
+{
+    return (SIM_CPU_FREQ_MHZ);
+}
+
+
+// ================================ Serial ================================
+
+static std::mutex serial_mutex;
+static std::deque<std::string> serial_lines;    // Input lines not yet sent.
+static std::string serial_sending;              // Line being read by the firmware.
+static bool serial_input_ended = false;
+static bool serial_awaiting_response = false;
+static bool serial_awaiting_welcome = true; // Input sent before the welcome message is flushed by the reset.
+static std::string serial_output_line;
+static uint32_t serial_output_count;        // Bytes written by the firmware.
+static int serial_input_fd = -1;
+static bool serial_input_taking = false;    // The reader thread is reading input.
+
+// A line of a single realtime command character is sent without its newline, like senders do. The
+// firmware does not answer it.
+static bool serial_is_realtime_line(const std::string &line)
+{
+    return ((line.size() == 2) && (line[0] == CMD_STATUS_REPORT || line[0] == CMD_FEED_HOLD || line[0] == CMD_CYCLE_START ||
+                                   (uint8_t)line[0] > 0x7F));
+}
+
+// Moves the next input line to the firmware. Called with serial_mutex held.
+static void serial_send_next_line()
+{
+    while (!serial_awaiting_welcome && !serial_awaiting_response && serial_sending.empty() && !serial_lines.empty())
+    {
+        serial_sending = serial_lines.front();
+        serial_lines.pop_front();
+        if (serial_sending[0] == CMD_RESET)
+        {
+            serial_sending.resize(1);
+            serial_awaiting_welcome = true;
+        }
+        else if (serial_is_realtime_line(serial_sending))
+        {
+            serial_sending.resize(1);
+        }
+        else
+        {
+            serial_awaiting_response = true;
+        }
+    }
+}
+
+// Queues an input line. Called with serial_mutex held.
+static void serial_add_line(const std::string &line)
+{
+    if (serial_is_realtime_line(line) && !serial_awaiting_welcome)
+    {
+        // Sent right away, like senders do, ahead of the lines still waiting for a response. The
+        // firmware picks realtime characters out of the stream, so they may split a line.
+        serial_sending.insert(0, 1, line[0]);
+        return;
+    }
+    serial_lines.push_back(line);
+    serial_send_next_line();
+}
+
+// Reads the input as it becomes available. The clock holds while input is waiting to be read, see
+// sim_serial_input_pending(), so a program read from a file arrives at the same virtual time on every run.
+static void serial_reader_thread()
+{
+    std::string line;
+    char buffer[256];
+    while (true)
+    {
+        struct pollfd input = { serial_input_fd, POLLIN, 0 };
+        poll(&input, 1, -1);
+        {
+            std::lock_guard<std::mutex> lock(serial_mutex);
+            serial_input_taking = true;
+        }
+        ssize_t count = read(serial_input_fd, buffer, sizeof(buffer));
+        {
+            std::lock_guard<std::mutex> lock(serial_mutex);
+            for (ssize_t idx = 0; idx < count; idx++)
+            {
+                line += buffer[idx];
+                if (buffer[idx] == '\n')
+                {
+                    serial_add_line(line);
+                    line.clear();
+                }
+            }
+            if (count <= 0)
+            {
+                if (!line.empty())
+                {
+                    serial_add_line(line + '\n');
+                }
+                serial_input_ended = true;
+            }
+            serial_input_taking = false;
+        }
+        sim_wake();
+        if (count <= 0)
+        {
+            return;
+        }
+    }
+}
+
+void sim_serial_start(int input_fd)
+{
+    serial_input_fd = input_fd;
+    std::thread(serial_reader_thread).detach();
+}
+
+bool sim_serial_input_pending()
+{
+    std::lock_guard<std::mutex> lock(serial_mutex);
+    if (serial_input_ended || (serial_input_fd < 0))
+    {
+        return (false);
+    }
+    struct pollfd input = { serial_input_fd, POLLIN, 0 };
+    return (serial_input_taking || (poll(&input, 1, 0) > 0));
+}
+
+// The main loop has nothing to do but wait: no line for it or its response in flight, no realtime command
+// and no queued motion to start. A suspended main loop waits in protocol_exec_rt_suspend() for the hold.
+bool sim_main_idle()
+{
+    {
+        std::lock_guard<std::mutex> lock(serial_mutex);
+        if (serial_awaiting_response || serial_awaiting_welcome || !serial_sending.empty())
+        {
+            return (false);
+        }
+    }
+    if (sys.suspend)
+    {
+        return (true);
+    }
+    return (((sys.state == STATE_IDLE) || (sys.state & (STATE_ALARM | STATE_SLEEP))) && !sys_rt_exec_state && !sys_rt_exec_alarm &&
+            !sys_rt_exec_motion_override && (plan_get_current_block() == NULL));
+}
+
+uint32_t sim_main_progress()
+{
+    uint32_t progress = plan_get_block_buffer_count();
+    progress = progress * 31 + sys.state;
+    progress = progress * 31 + sys_rt_exec_state;
+    std::lock_guard<std::mutex> lock(serial_mutex);
+    progress = progress * 31 + serial_output_count;
+    return (progress);
+}
+
+bool sim_serial_input_done()
+{
+    std::lock_guard<std::mutex> lock(serial_mutex);
+    return (serial_input_ended && serial_lines.empty() && serial_sending.empty() && !serial_awaiting_response);
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+}
+
+int HardwareSerial::available()
+{
+    std::lock_guard<std::mutex> lock(serial_mutex);
+    return (serial_sending.size());
+}
+
+int HardwareSerial::read()
+{
+    std::lock_guard<std::mutex> lock(serial_mutex);
+    if (serial_sending.empty())
+    {
+        return (-1);
+    }
+    int data = (uint8_t)serial_sending[0];
+    serial_sending.erase(0, 1);
+    serial_send_next_line();
+    return (data);
+}
+
+// UART0 of the ESP-IDF UART driver reads the same input as Serial. Its event queue waits for the
+// firmware's next input line and returns an UART_DATA event for it.
+struct sim_queue
+{
+};
+static sim_queue uart_event_queue;
+
+esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t *uart_config)
+{
+    return (ESP_OK);
+}
+
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size, int queue_size,
+                              QueueHandle_t *uart_queue, int intr_alloc_flags)
+{
+    if (uart_queue)
+    {
+        *uart_queue = &uart_event_queue;
+    }
+    return (ESP_OK);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    sim_wait([] { std::lock_guard<std::mutex> lock(serial_mutex); return (!serial_sending.empty()); },
+             (ticks_to_wait == portMAX_DELAY) ? SIM_WAIT_FOREVER : ((uint64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000));
+    std::lock_guard<std::mutex> lock(serial_mutex);
+    if (serial_sending.empty())
+    {
+        return (pdFALSE);
+    }
+    uart_event_t *event = (uart_event_t *)item;
+    event->type = UART_DATA;
+    event->size = serial_sending.size();
+    return (pdTRUE);
+}
+
+int uart_read_bytes(uart_port_t uart_num, uint8_t *buf, uint32_t length, TickType_t ticks_to_wait)
+{
+    std::lock_guard<std::mutex> lock(serial_mutex);
+    uint32_t count = serial_sending.size();
+    if (count > length)
+    {
+        count = length;
+    }
+    memcpy(buf, serial_sending.data(), count);
+    serial_sending.erase(0, count);
+    serial_send_next_line();
+    return (count);
+}
+
+int uart_write_bytes(uart_port_t uart_num, const char *src, size_t size)
+{
+    for (size_t n = 0; n < size; n++)
+    {
+        Serial.write(src[n]);
+    }
+    return (size);
+}
+
+// Prints a byte of output and sends the next input line after a response. Called with serial_mutex held.
+static void serial_output_byte(uint8_t c)
+{
+    putchar(c);
+    serial_output_count++;
+    if (c == '\n')
+    {
+        fflush(stdout);
+        sim_note_activity();
+        if (serial_output_line.compare(0, 2, "ok") == 0 || serial_output_line.compare(0, 5, "error") == 0)
+        {
+            serial_awaiting_response = false;
+            serial_send_next_line();
+        }
+        else if (serial_output_line.compare(0, 5, "Grbl ") == 0)
+        {
+            serial_awaiting_welcome = false;
+            serial_awaiting_response = false;
+            serial_send_next_line();
+        }
+        serial_output_line.clear();
+    }
+    else if (c != '\r')
+    {
+        serial_output_line += (char)c;
+    }
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    {
+        std::lock_guard<std::mutex> lock(serial_mutex);
+        serial_output_byte(c);
+    }
+    if (c == '\n')
+    {
+        sim_wake(); // A response may leave the main loop idle.
+    }
+    return (1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    for (size_t n = 0; n < size; n++)
+    {
+        write(buffer[n]);
+    }
+    return (size);
+}
+
+size_t HardwareSerial::print(const char *text)
+{
+    size_t count = 0;
+    while (*text)
+    {
+        count += write(*(text++));
+    }
+    return (count);
+}
+
+size_t HardwareSerial::print(char c)
+{
+    return (write(c));
+}
+
+size_t HardwareSerial::print(int n)
+{
+    char text[16];
+    snprintf(text, sizeof(text), "%d", n);
+    return (print(text));
+}
+
+size_t HardwareSerial::print(double n, int digits)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, n);
+    return (print(text));
+}
+
+size_t HardwareSerial::println(const char *text)
+{
+    return (print(text) + print("\r\n"));
+}
+
+size_t HardwareSerial::println(struct tm *timeinfo, const char *format)
+{
+    char text[64];
+    strftime(text, sizeof(text), format, timeinfo);
+    return (println(text));
+}
+
+size_t HardwareSerial::printf(const char *format, ...)
+{
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return (print(text));
+}
+
+void HardwareSerial::flush()
+{
+    fflush(stdout);
+}
+
+
+// ================================ EEPROM ================================
+
+static uint8_t eeprom_image[SIM_EEPROM_SIZE];
+static const char *eeprom_file = NULL;
+
+void sim_eeprom_set_file(const char *path)
+{
+    eeprom_file = path;
+}
+
+bool EEPROMClass::begin(size_t size)
+{
+    memset(eeprom_image, 0xFF, sizeof(eeprom_image)); // Erased flash.
+    if (eeprom_file)
+    {
+        FILE *file = fopen(eeprom_file, "rb");
+        if (file)
+        {
+            fread(eeprom_image, 1, sizeof(eeprom_image), file);
+            fclose(file);
+        }
+    }
+    return (size <= SIM_EEPROM_SIZE);
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+    return ((address < SIM_EEPROM_SIZE) ? eeprom_image[address] : 0xFF);
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+    if (address < SIM_EEPROM_SIZE)
+    {
+        eeprom_image[address] = value;
+    }
+}
+
+bool EEPROMClass::commit()
+{
+    if (!eeprom_file)
+    {
+        return (true);
+    }
+    FILE *file = fopen(eeprom_file, "wb");
+    if (!file)
+    {
+        return (false);
+    }
+    fwrite(eeprom_image, 1, sizeof(eeprom_image), file);
+    fclose(file);
+    return (true);
+}
+
+
+// ================================ Flash partitions ================================
+
+// The startup cache data partition of doc/partitions_startup_cache.csv. The app, nvs, eeprom and
+// spiffs partitions are not accessed through this API.
+static esp_partition_t cache_partition = { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x3F0000, 0x10000, "startup_cache", false };
+static std::vector<uint8_t> cache_image;
+static const char *flash_file = NULL;
+
+void sim_flash_set_file(const char *path)
+{
+    flash_file = path;
+}
+
+// Erased flash, or the image file on first access.
+static void flash_load()
+{
+    if (!cache_image.empty())
+    {
+        return;
+    }
+    cache_image.assign(cache_partition.size, 0xFF);
+    if (flash_file)
+    {
+        FILE *file = fopen(flash_file, "rb");
+        if (file)
+        {
+            fread(cache_image.data(), 1, cache_image.size(), file);
+            fclose(file);
+        }
+    }
+}
+
+static void flash_store()
+{
+    if (flash_file)
+    {
+        FILE *file = fopen(flash_file, "wb");
+        if (file)
+        {
+            fwrite(cache_image.data(), 1, cache_image.size(), file);
+            fclose(file);
+        }
+    }
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label)
+{
+    if ((type != ESP_PARTITION_TYPE_DATA) || ((subtype != ESP_PARTITION_SUBTYPE_ANY) && (subtype != cache_partition.subtype)) ||
+            (label && strcmp(label, cache_partition.label)))
+    {
+        return (NULL);
+    }
+    return (&cache_partition);
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    if ((src_offset + size) > partition->size)
+    {
+        return (ESP_ERR_INVALID_SIZE);
+    }
+    flash_load();
+    memcpy(dst, &cache_image[src_offset], size);
+    return (ESP_OK);
+}
+
+// Like NOR flash, a write can only clear bits. Erase sets them.
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+    if ((dst_offset + size) > partition->size)
+    {
+        return (ESP_ERR_INVALID_SIZE);
+    }
+    flash_load();
+    const uint8_t *data = (const uint8_t *)src;
+    for (size_t idx = 0; idx < size; idx++)
+    {
+        cache_image[dst_offset + idx] &= data[idx];
+    }
+    flash_store();
+    return (ESP_OK);
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t start_addr, size_t size)
+{
+    if (((start_addr % SPI_FLASH_SEC_SIZE) != 0) || ((size % SPI_FLASH_SEC_SIZE) != 0) || ((start_addr + size) > partition->size))
+    {
+        return (ESP_ERR_INVALID_SIZE);
+    }
+    flash_load();
+    memset(&cache_image[start_addr], 0xFF, size);
+    flash_store();
+    return (ESP_OK);
+}
+
+
+// ================================ WiFi ================================
+
+void WiFiClass::begin(const char *ssid, const char *password)
+{
+}
+
+int WiFiClass::status()
+{
+    return (WL_CONNECTED);
+}
+
+bool WiFiClass::disconnect(bool wifi_off)
+{
+    return (true);
+}
+
+bool WiFiClass::mode(int mode)
+{
+    return (true);
+}
+
+void configTime(long gmt_offset_sec, int daylight_offset_sec, const char *server)
+{
+}
+
+bool getLocalTime(struct tm *info, uint32_t ms)
+{
+    time_t now = time(NULL);
+    localtime_r(&now, info);
+    return (true);
+}
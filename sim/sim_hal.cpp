@@ -0,0 +1,746 @@
+/*
+    sim_hal.cpp - virtual clock, timer group 0, GPIO and RMT of the Grbl_Esp32 host simulation
+    Part of the Grbl_Esp32 host simulation, see sim_hal.h
+*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "driver/timer.h"
+#include "driver/rmt.h"
+#include "soc/gpio_struct.h"
+#include "sim_hal.h"
+
+#define SIM_GPIO_COUNT 40
+#define SIM_RMT_ITEMS 64 // One memory block per channel.
+#define SIM_CLOCK_PERIOD_US 100 // Real time between virtual timer thread updates.
+#define SIM_MAIN_SPIN_PASSES 4 // Yield points the main loop passes without progress before it waits for the clock.
+#define SIM_MAIN_STUCK_MS 1000 // Real time after which a busy main loop without yield points no longer holds the clock.
+
+timg_dev_t TIMERG0;
+rmt_dev_t RMT;
+gpio_dev_t GPIO = { {0, true}, {0, false}, {{1, true}}, {{1, false}} };
+
+static double clock_speed = 1.0;
+static std::chrono::steady_clock::time_point clock_start;
+static volatile uint64_t clock_ticks; // Written only by the virtual timer thread.
+static std::atomic<uint64_t> activity_ticks; // See sim_activity_ticks().
+static std::recursive_mutex interrupt_mutex;
+
+// Timer group 0 state behind the register shim.
+typedef struct
+{
+    uint32_t divider;
+    bool auto_reload;
+    bool running;
+    uint64_t zero_ticks;    // Virtual time at which the counter was 0, while running.
+    uint64_t paused_count;  // Counter value, while paused.
+    void (*isr)(void *);
+    void *isr_arg;
+    uint64_t isr_count;
+} sim_timer_t;
+static sim_timer_t timers[TIMER_MAX];
+
+// RMT transmitter state behind the register shim.
+typedef struct
+{
+    int8_t gpio;
+    uint8_t clk_div;
+    rmt_item32_t items[SIM_RMT_ITEMS];
+    uint8_t idle_level;
+} sim_rmt_channel_t;
+static sim_rmt_channel_t rmt_channels[RMT_CHANNEL_MAX];
+
+// Pending pin changes played by the RMT.
+typedef struct
+{
+    uint64_t ticks;
+    uint8_t pin;
+    uint8_t level;
+} sim_pin_event_t;
+static std::vector<sim_pin_event_t> pin_events;
+
+static std::mutex gpio_mutex;
+static uint8_t gpio_level[SIM_GPIO_COUNT];
+static uint8_t gpio_mode[SIM_GPIO_COUNT];
+static uint64_t gpio_edges[SIM_GPIO_COUNT][2];
+static const char *gpio_name[SIM_GPIO_COUNT];
+static FILE *trace_file = NULL;
+
+
+// ================================ Virtual clock ================================
+
+double sim_clock_speed()
+{
+    return (clock_speed);
+}
+
+uint64_t sim_ticks()
+{
+    return (clock_ticks);
+}
+
+uint64_t sim_activity_ticks()
+{
+    return (activity_ticks);
+}
+
+void sim_note_activity()
+{
+    activity_ticks = clock_ticks;
+}
+
+double sim_real_seconds()
+{
+    return (std::chrono::duration<double>(std::chrono::steady_clock::now() - clock_start).count());
+}
+
+void sim_sleep_us(uint64_t virtual_us)
+{
+    sim_wait([] { return (false); }, virtual_us);
+}
+
+void sim_interrupt_lock()
+{
+    interrupt_mutex.lock();
+}
+
+void sim_interrupt_unlock()
+{
+    interrupt_mutex.unlock();
+}
+
+
+// ================================ Virtual scheduler ================================
+
+// A thread waiting in sim_wait().
+typedef struct
+{
+    std::function<bool()> ready;
+    uint64_t deadline_ticks;
+    bool main;
+    bool woken;
+    bool result;
+} sim_waiter_t;
+
+static std::mutex sched_mutex;
+static std::condition_variable sched_signal;    // Notified on every change of the scheduler state.
+static int sched_running_tasks;                 // Tasks not waiting in sim_wait().
+static std::list<sim_waiter_t *> sched_waiters;
+static bool main_waiting;                       // The main loop waits in sim_wait().
+static bool main_yielded;                       // The main loop waits for the clock to advance.
+static uint64_t sched_epoch;                    // Counts the clock advances and task handoffs.
+static thread_local bool main_thread = false;
+
+// Main loop progress, seen at its yield points.
+static uint32_t main_progress;
+static uint64_t main_epoch;
+static uint8_t main_spins;
+
+void sim_task_created()
+{
+    std::lock_guard<std::mutex> lock(sched_mutex);
+    sched_running_tasks++;
+}
+
+void sim_main_thread()
+{
+    main_thread = true;
+}
+
+// Wakes the waiters that are ready or due. Called with sched_mutex held.
+static void sched_wake_ready(uint64_t now)
+{
+    for (auto waiter = sched_waiters.begin(); waiter != sched_waiters.end();)
+    {
+        bool ready = (*waiter)->ready();
+        if (!ready && ((*waiter)->deadline_ticks > now))
+        {
+            waiter++;
+            continue;
+        }
+        (*waiter)->woken = true;
+        (*waiter)->result = ready;
+        if ((*waiter)->main)
+        {
+            main_waiting = false;
+        }
+        else
+        {
+            sched_running_tasks++;
+        }
+        waiter = sched_waiters.erase(waiter);
+        sched_signal.notify_all();
+    }
+}
+
+// Returns true while a firmware thread is runnable or input is on its way. Called with sched_mutex held.
+static bool sched_busy()
+{
+    return ((sched_running_tasks > 0) || (!main_waiting && !main_yielded && !sim_main_idle()) || sim_serial_input_pending());
+}
+
+// Returns the earliest deadline of the waiters. Called with sched_mutex held.
+static uint64_t sched_next_deadline()
+{
+    uint64_t deadline = SIM_WAIT_FOREVER;
+    for (sim_waiter_t *waiter : sched_waiters)
+    {
+        if (waiter->deadline_ticks < deadline)
+        {
+            deadline = waiter->deadline_ticks;
+        }
+    }
+    return (deadline);
+}
+
+// Lets a yielded main loop look again for work. Called with sched_mutex held.
+static void sched_release_main()
+{
+    sched_epoch++;
+    if (main_yielded)
+    {
+        main_yielded = false;
+        sched_signal.notify_all();
+    }
+}
+
+// Called by the clock after each advance. Returns true if a thread became runnable, which stops the clock.
+static bool sched_clock_advanced(uint64_t now)
+{
+    std::lock_guard<std::mutex> lock(sched_mutex);
+    sched_release_main();
+    sched_wake_ready(now);
+    return (sched_busy());
+}
+
+bool sim_wait(std::function<bool()> ready, uint64_t timeout_us)
+{
+    std::unique_lock<std::mutex> lock(sched_mutex);
+    if (ready())
+    {
+        return (true);
+    }
+    sim_waiter_t waiter;
+    waiter.ready = ready;
+    waiter.deadline_ticks = (timeout_us == SIM_WAIT_FOREVER) ? SIM_WAIT_FOREVER : (clock_ticks + timeout_us * SIM_TICKS_PER_MICROSECOND);
+    waiter.main = main_thread;
+    waiter.woken = false;
+    waiter.result = false;
+    sched_waiters.push_back(&waiter);
+    if (main_thread)
+    {
+        main_waiting = true;
+    }
+    else
+    {
+        sched_running_tasks--;
+        sched_release_main(); // The task may have left work for the main loop.
+    }
+    sched_signal.notify_all();
+    sched_signal.wait(lock, [&waiter] { return (waiter.woken); });
+    return (waiter.result);
+}
+
+void sim_wake()
+{
+    std::lock_guard<std::mutex> lock(sched_mutex);
+    sched_release_main();
+    sched_signal.notify_all();
+}
+
+void sim_main_yield_point()
+{
+    if (!main_thread)
+    {
+        return;
+    }
+    uint32_t progress = sim_main_progress();
+    std::unique_lock<std::mutex> lock(sched_mutex);
+    if ((progress != main_progress) || (sched_epoch != main_epoch))
+    {
+        main_progress = progress;
+        main_epoch = sched_epoch;
+        main_spins = 0;
+        return;
+    }
+    if (++main_spins < SIM_MAIN_SPIN_PASSES)
+    {
+        return;
+    }
+    main_spins = 0;
+    main_yielded = true;
+    sched_signal.notify_all();
+    sched_signal.wait(lock, [] { return (!main_yielded); });
+}
+
+uint64_t sim_timer_isr_count(uint8_t timer_num)
+{
+    return (timers[timer_num].isr_count);
+}
+
+static uint64_t timer_count(sim_timer_t *timer, uint64_t now)
+{
+    if (timer->running)
+    {
+        return ((now - timer->zero_ticks) / timer->divider);
+    }
+    return (timer->paused_count);
+}
+
+// Applies the register writes of the firmware to the timer state. Called after every handler and
+// by the timer driver functions. Reload is used as a write strobe to load the counter.
+static void timer_sync(uint8_t timer_num, uint64_t now)
+{
+    sim_timer_t *timer = &timers[timer_num];
+    timg_hwtimer_reg_t *regs = &TIMERG0.hw_timer[timer_num];
+    if (regs->reload)
+    {
+        regs->reload = 0;
+        uint64_t load = ((uint64_t)regs->load_high << 32) | regs->load_low;
+        timer->zero_ticks = now - load * timer->divider;
+        timer->paused_count = load;
+    }
+    if (regs->config.enable && !timer->running)
+    {
+        timer->running = true;
+        timer->zero_ticks = now - timer->paused_count * timer->divider;
+    }
+    else if (!regs->config.enable && timer->running)
+    {
+        timer->paused_count = timer_count(timer, now);
+        timer->running = false;
+    }
+}
+
+// Returns the virtual time of the next alarm of a timer, or false if none is armed.
+static bool timer_next_alarm(uint8_t timer_num, uint64_t now, uint64_t *alarm_ticks)
+{
+    sim_timer_t *timer = &timers[timer_num];
+    timg_hwtimer_reg_t *regs = &TIMERG0.hw_timer[timer_num];
+    if (!timer->isr || !timer->running || !regs->config.alarm_en)
+    {
+        return (false);
+    }
+    uint64_t alarm = ((uint64_t)regs->alarm_high << 32) | regs->alarm_low;
+    if (alarm == 0)
+    {
+        alarm = 1; // An alarm at the reload value would fire continuously.
+    }
+    *alarm_ticks = timer->zero_ticks + alarm * timer->divider;
+    if (*alarm_ticks < now)
+    {
+        *alarm_ticks = now; // Already past. Fires right away.
+    }
+    return (true);
+}
+
+static void rmt_sync(uint64_t now);
+
+static void timer_fire(uint8_t timer_num, uint64_t now)
+{
+    sim_timer_t *timer = &timers[timer_num];
+    timg_hwtimer_reg_t *regs = &TIMERG0.hw_timer[timer_num];
+    regs->config.alarm_en = 0; // Cleared by the hardware on alarm.
+    if (timer->auto_reload)
+    {
+        timer->zero_ticks = now;
+    }
+    regs->cnt_low = (uint32_t)timer_count(timer, now);
+    regs->cnt_high = (uint32_t)(timer_count(timer, now) >> 32);
+    timer->isr_count++;
+    activity_ticks = now;
+    timer->isr(timer->isr_arg);
+    regs->update = 0;
+    TIMERG0.int_clr_timers.t0 = 0;
+    TIMERG0.int_clr_timers.t1 = 0;
+    for (uint8_t idx = 0; idx < TIMER_MAX; idx++)
+    {
+        timer_sync(idx, now);
+    }
+    rmt_sync(now);
+}
+
+// Fires all timer alarms and RMT pin changes due by the target virtual time, in time order.
+static void clock_advance(uint64_t target)
+{
+    sim_interrupt_lock();
+    uint64_t now = clock_ticks;
+    for (uint8_t idx = 0; idx < TIMER_MAX; idx++)
+    {
+        timer_sync(idx, now);
+    }
+    rmt_sync(now);
+    while (true)
+    {
+        uint64_t next = target + 1;
+        int8_t next_timer = -1;
+        uint64_t alarm_ticks;
+        for (uint8_t idx = 0; idx < TIMER_MAX; idx++)
+        {
+            if (timer_next_alarm(idx, now, &alarm_ticks) && (alarm_ticks < next))
+            {
+                next = alarm_ticks;
+                next_timer = idx;
+            }
+        }
+        int next_event = -1;
+        for (size_t idx = 0; idx < pin_events.size(); idx++)
+        {
+            if (pin_events[idx].ticks < next)
+            {
+                next = pin_events[idx].ticks;
+                next_event = idx;
+                next_timer = -1;
+            }
+        }
+        bool deadline = false;
+        {
+            std::lock_guard<std::mutex> lock(sched_mutex);
+            if (sched_next_deadline() < next)
+            {
+                next = sched_next_deadline();
+                deadline = true;
+            }
+        }
+        if (next > target)
+        {
+            break;
+        }
+        now = next;
+        clock_ticks = now;
+        if (deadline)
+        {
+            // A waiter is due. Woken below.
+        }
+        else if (next_event >= 0)
+        {
+            sim_pin_event_t event = pin_events[next_event];
+            pin_events.erase(pin_events.begin() + next_event);
+            sim_gpio_set_level(event.pin, event.level);
+        }
+        else
+        {
+            timer_fire(next_timer, now);
+        }
+        if (sched_clock_advanced(now))
+        {
+            sim_interrupt_unlock();
+            return; // Runs the woken threads before anything else happens.
+        }
+    }
+    clock_ticks = target;
+    sched_clock_advanced(target);
+    sim_interrupt_unlock();
+}
+
+// Advances virtual time towards speed times real time, whenever no firmware thread is runnable.
+static void clock_thread()
+{
+    std::unique_lock<std::mutex> lock(sched_mutex);
+    auto busy_since = std::chrono::steady_clock::now();
+    while (true)
+    {
+        sched_wake_ready(clock_ticks);
+        if (sched_busy())
+        {
+            // A main loop that spins in a wait loop without yield points would hold the clock forever.
+            bool stuck = (sched_running_tasks == 0) && !sim_serial_input_pending() &&
+                         (std::chrono::steady_clock::now() - busy_since > std::chrono::milliseconds(SIM_MAIN_STUCK_MS));
+            if (!stuck)
+            {
+                sched_signal.wait_for(lock, std::chrono::microseconds(SIM_CLOCK_PERIOD_US));
+                continue;
+            }
+        }
+        uint64_t target = (uint64_t)(sim_real_seconds() * 1000000.0 * clock_speed * SIM_TICKS_PER_MICROSECOND);
+        lock.unlock();
+        if (target > clock_ticks)
+        {
+            clock_advance(target);
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(SIM_CLOCK_PERIOD_US));
+        }
+        lock.lock();
+        busy_since = std::chrono::steady_clock::now();
+    }
+}
+
+void sim_clock_start(double speed)
+{
+    clock_speed = speed;
+    clock_start = std::chrono::steady_clock::now();
+    std::thread(clock_thread).detach();
+}
+
+
+// ================================ Timer driver ================================
+
+esp_err_t timer_init(timer_group_t group_num, timer_idx_t timer_num, const timer_config_t *config)
+{
+    sim_interrupt_lock();
+    timers[timer_num].divider = config->divider;
+    timers[timer_num].auto_reload = config->auto_reload;
+    TIMERG0.hw_timer[timer_num].config.divider = config->divider;
+    TIMERG0.hw_timer[timer_num].config.autoreload = config->auto_reload;
+    TIMERG0.hw_timer[timer_num].config.increase = (config->counter_dir == TIMER_COUNT_UP);
+    TIMERG0.hw_timer[timer_num].config.alarm_en = config->alarm_en;
+    TIMERG0.hw_timer[timer_num].config.enable = config->counter_en;
+    timer_sync(timer_num, clock_ticks);
+    sim_interrupt_unlock();
+    return (ESP_OK);
+}
+
+esp_err_t timer_set_counter_value(timer_group_t group_num, timer_idx_t timer_num, uint64_t load_val)
+{
+    sim_interrupt_lock();
+    TIMERG0.hw_timer[timer_num].load_high = (uint32_t)(load_val >> 32);
+    TIMERG0.hw_timer[timer_num].load_low = (uint32_t)load_val;
+    TIMERG0.hw_timer[timer_num].reload = 1;
+    timer_sync(timer_num, clock_ticks);
+    sim_interrupt_unlock();
+    return (ESP_OK);
+}
+
+esp_err_t timer_set_alarm_value(timer_group_t group_num, timer_idx_t timer_num, uint64_t alarm_value)
+{
+    sim_interrupt_lock();
+    TIMERG0.hw_timer[timer_num].alarm_high = (uint32_t)(alarm_value >> 32);
+    TIMERG0.hw_timer[timer_num].alarm_low = (uint32_t)alarm_value;
+    sim_interrupt_unlock();
+    return (ESP_OK);
+}
+
+esp_err_t timer_start(timer_group_t group_num, timer_idx_t timer_num)
+{
+    sim_interrupt_lock();
+    TIMERG0.hw_timer[timer_num].config.enable = 1;
+    timer_sync(timer_num, clock_ticks);
+    sim_interrupt_unlock();
+    return (ESP_OK);
+}
+
+esp_err_t timer_pause(timer_group_t group_num, timer_idx_t timer_num)
+{
+    sim_interrupt_lock();
+    TIMERG0.hw_timer[timer_num].config.enable = 0;
+    timer_sync(timer_num, clock_ticks);
+    sim_interrupt_unlock();
+    return (ESP_OK);
+}
+
+esp_err_t timer_enable_intr(timer_group_t group_num, timer_idx_t timer_num)
+{
+    TIMERG0.hw_timer[timer_num].config.level_int_en = 1;
+    return (ESP_OK);
+}
+
+esp_err_t timer_isr_register(timer_group_t group_num, timer_idx_t timer_num, void (*fn)(void *), void *arg,
+                             int intr_alloc_flags, void *handle)
+{
+    sim_interrupt_lock();
+    timers[timer_num].isr = fn;
+    timers[timer_num].isr_arg = arg;
+    sim_interrupt_unlock();
+    return (ESP_OK);
+}
+
+
+// ================================ RMT driver ================================
+
+esp_err_t rmt_config(const rmt_config_t *rmt_param)
+{
+    sim_interrupt_lock();
+    sim_rmt_channel_t *channel = &rmt_channels[rmt_param->channel];
+    channel->gpio = rmt_param->gpio_num;
+    channel->clk_div = rmt_param->clk_div;
+    channel->idle_level = rmt_param->tx_config.idle_level;
+    RMT.conf_ch[rmt_param->channel].conf1.idle_out_lv = rmt_param->tx_config.idle_level;
+    RMT.conf_ch[rmt_param->channel].conf1.idle_out_en = rmt_param->tx_config.idle_output_en;
+    sim_interrupt_unlock();
+    sim_gpio_set_level(channel->gpio, channel->idle_level);
+    return (ESP_OK);
+}
+
+esp_err_t rmt_fill_tx_items(rmt_channel_t channel, const rmt_item32_t *item, uint16_t item_num, uint16_t mem_offset)
+{
+    sim_interrupt_lock();
+    for (uint16_t idx = 0; (idx < item_num) && ((mem_offset + idx) < SIM_RMT_ITEMS); idx++)
+    {
+        rmt_channels[channel].items[mem_offset + idx].val = item[idx].val;
+    }
+    sim_interrupt_unlock();
+    return (ESP_OK);
+}
+
+// Plays the items of every started channel onto its pin and follows idle level changes.
+static void rmt_sync(uint64_t now)
+{
+    for (uint8_t ch = 0; ch < RMT_CHANNEL_MAX; ch++)
+    {
+        sim_rmt_channel_t *channel = &rmt_channels[ch];
+        if (!channel->clk_div)
+        {
+            continue;
+        }
+        RMT.conf_ch[ch].conf1.mem_rd_rst = 0;
+        if (channel->idle_level != RMT.conf_ch[ch].conf1.idle_out_lv)
+        {
+            channel->idle_level = RMT.conf_ch[ch].conf1.idle_out_lv;
+            sim_gpio_set_level(channel->gpio, channel->idle_level);
+        }
+        if (!RMT.conf_ch[ch].conf1.tx_start)
+        {
+            continue;
+        }
+        RMT.conf_ch[ch].conf1.tx_start = 0;
+        uint64_t ticks = now;
+        for (uint8_t idx = 0; idx < SIM_RMT_ITEMS; idx++)
+        {
+            rmt_item32_t *item = &channel->items[idx];
+            if (item->duration0 == 0)
+            {
+                break;
+            }
+            pin_events.push_back({ticks, (uint8_t)channel->gpio, (uint8_t)item->level0});
+            ticks += (uint64_t)item->duration0 * channel->clk_div;
+            if (item->duration1 == 0)
+            {
+                break;
+            }
+            pin_events.push_back({ticks, (uint8_t)channel->gpio, (uint8_t)item->level1});
+            ticks += (uint64_t)item->duration1 * channel->clk_div;
+        }
+        pin_events.push_back({ticks, (uint8_t)channel->gpio, channel->idle_level});
+    }
+}
+
+
+// ================================ GPIO ================================
+
+void sim_gpio_set_mode(uint8_t pin, uint8_t mode)
+{
+    if (pin >= SIM_GPIO_COUNT)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(gpio_mutex);
+    gpio_mode[pin] = mode;
+    if (mode == INPUT_PULLUP)
+    {
+        gpio_level[pin] = HIGH; // Nothing is connected to the simulated inputs.
+    }
+}
+
+void sim_gpio_set_level(uint8_t pin, uint8_t level)
+{
+    if (pin >= SIM_GPIO_COUNT)
+    {
+        return;
+    }
+    level = (level != 0);
+    std::lock_guard<std::mutex> lock(gpio_mutex);
+    if (gpio_level[pin] == level)
+    {
+        return;
+    }
+    gpio_level[pin] = level;
+    gpio_edges[pin][level]++;
+    if (trace_file && gpio_name[pin])
+    {
+        fprintf(trace_file, "%.4f %s %u\n", (double)clock_ticks / SIM_TICKS_PER_MICROSECOND, gpio_name[pin], level);
+    }
+}
+
+uint8_t sim_gpio_get_level(uint8_t pin)
+{
+    if (pin >= SIM_GPIO_COUNT)
+    {
+        return (LOW);
+    }
+    return (gpio_level[pin]);
+}
+
+uint64_t sim_gpio_edge_count(uint8_t pin, uint8_t level)
+{
+    if (pin >= SIM_GPIO_COUNT)
+    {
+        return (0);
+    }
+    return (gpio_edges[pin][level != 0]);
+}
+
+void sim_gpio_write_mask(uint8_t bank, bool set, uint32_t mask)
+{
+    for (uint8_t bit_idx = 0; bit_idx < 32; bit_idx++)
+    {
+        if (mask & (1UL << bit_idx))
+        {
+            sim_gpio_set_level(bank * 32 + bit_idx, set ? HIGH : LOW);
+        }
+    }
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    sim_gpio_set_mode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    sim_gpio_set_level(pin, val);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return (sim_gpio_get_level(pin));
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode)
+{
+    // Simulated inputs never change, so pin change interrupts never fire.
+}
+
+void detachInterrupt(uint8_t pin)
+{
+}
+
+
+// ================================ Trace ================================
+
+bool sim_trace_open(const char *path)
+{
+    trace_file = fopen(path, "w");
+    if (!trace_file)
+    {
+        return (false);
+    }
+    fprintf(trace_file, "# Grbl_Esp32 simulation pin trace: time_us pin level\n");
+    return (true);
+}
+
+void sim_trace_name_pin(uint8_t pin, const char *name)
+{
+    if (pin < SIM_GPIO_COUNT)
+    {
+        gpio_name[pin] = name;
+    }
+}
+
+void sim_trace_close()
+{
+    std::lock_guard<std::mutex> lock(gpio_mutex);
+    if (trace_file)
+    {
+        fclose(trace_file);
+        trace_file = NULL;
+    }
+}
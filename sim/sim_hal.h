@@ -0,0 +1,93 @@
+/*
+    sim_hal.h - host simulation of the ESP32 hardware used by the Grbl_Esp32 motion core
+    Part of the Grbl_Esp32 host simulation
+
+    The firmware sources are compiled unchanged against the shim headers in sim/include. Virtual
+    time follows a fixed multiple of real time. A virtual timer thread fires the timer group 0
+    handlers, like onStepperDriverTimer(), at their programmed alarm values. While it runs a
+    handler, it holds the simulated interrupt lock. FreeRTOS critical sections take the same lock,
+    so a critical section keeps the handlers out, like interrupt masking on the ESP32.
+    Virtual time stands still while a firmware thread is runnable, so the firmware computes in no
+    virtual time and runs the same at any speed, no matter how fast the host is. Tasks wait in
+    sim_wait(). The main loop has no blocking waits. It counts as waiting while it has nothing to do,
+    see sim_main_idle(), and while it spins in a wait loop, see sim_main_yield_point().
+    Every change of a named pin is written to the trace file as a line with the virtual time in
+    microseconds, the pin name, and the new level.
+*/
+
+#ifndef sim_hal_h
+#define sim_hal_h
+
+#include <functional>
+#include <stdint.h>
+
+#define SIM_TICKS_PER_MICROSECOND 80 // Virtual time base. The 80MHz APB clock of the ESP32 timers.
+
+// Starts virtual time at speed times real time, and the virtual timer thread.
+void sim_clock_start(double speed);
+double sim_clock_speed();
+// Virtual time since start in APB ticks.
+uint64_t sim_ticks();
+// Virtual time of the last interrupt or output line, in APB ticks. The end of a program's run,
+// independent of when the run is noticed.
+uint64_t sim_activity_ticks();
+void sim_note_activity();
+// Real time since start in seconds.
+double sim_real_seconds();
+// Sleeps for the given virtual time.
+void sim_sleep_us(uint64_t virtual_us);
+
+// Virtual scheduler.
+#define SIM_WAIT_FOREVER UINT64_MAX
+// Counts a firmware task as runnable from its creation on.
+void sim_task_created();
+// Marks the calling thread as the main loop.
+void sim_main_thread();
+// Waits until ready() returns true or the virtual timeout passed and returns ready(). ready() is
+// evaluated with the scheduler lock held, so it must not call back into the scheduler.
+bool sim_wait(std::function<bool()> ready, uint64_t timeout_us);
+// Tells the scheduler that a condition of a waiting thread may have changed. Not to be called with a
+// lock held that a ready() function takes.
+void sim_wake();
+// Called by the shims at points the main loop passes in its wait loops, like taking the segment prep
+// mutex. When the main loop passes several of them without progress, it waits for virtual time to
+// advance.
+void sim_main_yield_point();
+// Provided by sim_arduino.cpp for the scheduler: the main loop has nothing to do, a firmware state
+// that changes when the main loop makes progress, and input waiting to be read.
+bool sim_main_idle();
+uint32_t sim_main_progress();
+bool sim_serial_input_pending();
+
+// Simulated interrupt masking. Recursive.
+void sim_interrupt_lock();
+void sim_interrupt_unlock();
+
+// Number of calls of the timer group 0 handlers.
+uint64_t sim_timer_isr_count(uint8_t timer_num);
+
+// Simulated GPIO pins.
+void sim_gpio_set_mode(uint8_t pin, uint8_t mode);
+void sim_gpio_set_level(uint8_t pin, uint8_t level);
+uint8_t sim_gpio_get_level(uint8_t pin);
+// Counts the changes of a pin to the given level, like step pulses.
+uint64_t sim_gpio_edge_count(uint8_t pin, uint8_t level);
+
+// Pin change trace. Only named pins are traced.
+bool sim_trace_open(const char *path);
+void sim_trace_name_pin(uint8_t pin, const char *name);
+void sim_trace_close();
+
+// Serial port. Lines read from the input are sent one at a time, each after the firmware
+// answered the previous one with ok or error, like a send-response g-code sender.
+void sim_serial_start(int input_fd);
+bool sim_serial_input_done(); // Input ended and every line was answered.
+
+// EEPROM image file. Loaded on start, when it exists, and written on every commit.
+void sim_eeprom_set_file(const char *path);
+
+// Flash image file of the startup cache data partition. Loaded on first access, when it exists, and written
+// on every write or erase.
+void sim_flash_set_file(const char *path);
+
+#endif
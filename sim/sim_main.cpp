@@ -0,0 +1,166 @@
+/*
+    sim_main.cpp - entry point of the Grbl_Esp32 host simulation
+    Part of the Grbl_Esp32 host simulation, see sim_hal.h
+
+    Usage: grbl_sim [-t trace_file] [-j step_trace_file] [-s speed] [-e eeprom_file] [-f flash_file] < program.nc
+
+    Streams the g-code read from stdin to the firmware and prints its responses to stdout. Exits
+    once every line was answered and the machine is idle again, with a summary on stderr.
+*/
+
+#include <thread>
+#include <unistd.h>
+
+#include "grbl.h"
+#include "sim_hal.h"
+
+#define SIM_IDLE_CHECKS 5           // Consecutive idle checks before exiting.
+#define SIM_IDLE_CHECK_PERIOD_MS 20 // Real time between idle checks.
+
+void setup();
+void loop();
+
+static const char *trace_path = NULL;
+static const char *step_trace_path = NULL;
+
+static void sim_usage()
+{
+    fprintf(stderr, "usage: grbl_sim [-t trace_file] [-j step_trace_file] [-s speed] [-e eeprom_file] [-f flash_file] < program.nc\n");
+    fprintf(stderr, "  -t  write step, direction and enable pin changes to trace_file\n");
+    fprintf(stderr, "  -j  write the stepper ISR step pulse trace ($T) to step_trace_file at exit, with STEP_TRACE\n");
+    fprintf(stderr, "  -s  run virtual time at speed times real time (default 1)\n");
+    fprintf(stderr, "  -e  load and store the EEPROM image in eeprom_file\n");
+    fprintf(stderr, "  -f  load and store the startup cache flash partition image in flash_file\n");
+    exit(2);
+}
+
+#ifdef STEP_TRACE
+// One step pulse per line: CPU cycle counter, cycles since the previous pulse, step bits, direction bits.
+// The cycle counter runs on host time, so the trace shows the jitter of the host build.
+static void sim_write_step_trace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        perror(path);
+        return;
+    }
+    st_step_trace_entry_t entry;
+    uint32_t count = st_step_trace_count();
+    uint32_t first = (count > STEP_TRACE_SIZE) ? (count - STEP_TRACE_SIZE) : 0;
+    uint32_t last_cycles = 0;
+    fprintf(file, "# %u step pulses, %u dropped, %u MHz\n# cycles delta step dir\n", count - first, first, ESP.getCpuFreqMHz());
+    for (uint32_t n = first; n < count; n++)
+    {
+        st_step_trace_get(n, &entry);
+        fprintf(file, "%u %u %u %u\n", entry.cycles, (n == first) ? 0 : (entry.cycles - last_cycles), entry.step_bits, entry.dir_bits);
+        last_cycles = entry.cycles;
+    }
+    fclose(file);
+}
+#endif
+
+// Exits once the input was fully answered and all motion completed.
+static void sim_monitor_thread()
+{
+    uint8_t idle_checks = 0;
+    while (idle_checks < SIM_IDLE_CHECKS)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(SIM_IDLE_CHECK_PERIOD_MS));
+        if (sim_serial_input_done() && (sys.state == STATE_IDLE || sys.state == STATE_ALARM)
+                && (plan_get_current_block() == NULL))
+        {
+            idle_checks++;
+        }
+        else
+        {
+            idle_checks = 0;
+        }
+    }
+
+    sim_interrupt_lock(); // Freeze the machine for the summary.
+    sim_trace_close();
+#ifdef STEP_TRACE
+    if (step_trace_path)
+    {
+        sim_write_step_trace(step_trace_path);
+    }
+#endif
+    double virtual_s = (double)sim_activity_ticks() / (SIM_TICKS_PER_MICROSECOND * 1000000.0);
+    fprintf(stderr, "[SIM: %.3fs virtual, %.3fs real, %llu step ISRs]\n", virtual_s,
+            sim_real_seconds(), (unsigned long long)sim_timer_isr_count(STEP_TIMER_INDEX));
+    fprintf(stderr, "[SIM STEPS: X%llu Y%llu]\n", (unsigned long long)sim_gpio_edge_count(X_STEP_PIN, HIGH),
+            (unsigned long long)sim_gpio_edge_count(Y_STEP_PIN, HIGH));
+    fprintf(stderr, "[SIM POS: X%ld Y%ld]\n", (long)sys_position[X_AXIS], (long)sys_position[Y_AXIS]);
+    st_underrun_stats_t underrun;
+    st_get_underrun_stats(&underrun);
+    fprintf(stderr, "[SIM STOPS: %u, %u starved]\n", underrun.stop_count, underrun.starvation_count);
+#ifdef STEPPER_ISR_PROFILER
+    plan_recalculate_profile_t plan_profile;
+    plan_get_recalculate_profile(&plan_profile);
+    fprintf(stderr, "[SIM PLAN: %u blocks, %llu replanned, %u max, buffer %u]\n", plan_profile.count,
+            (unsigned long long)plan_profile.total_blocks, plan_profile.max_blocks, plan_get_block_buffer_size() - 1);
+#endif
+    fflush(stdout);
+    _exit(sys.state == STATE_ALARM ? 1 : 0);
+}
+
+int main(int argc, char *argv[])
+{
+    double speed = 1.0;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:j:s:e:f:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 't':
+                trace_path = optarg;
+                break;
+            case 'j':
+                step_trace_path = optarg;
+                break;
+            case 's':
+                speed = atof(optarg);
+                if (speed <= 0.0)
+                {
+                    sim_usage();
+                }
+                break;
+            case 'e':
+                sim_eeprom_set_file(optarg);
+                break;
+            case 'f':
+                sim_flash_set_file(optarg);
+                break;
+            default:
+                sim_usage();
+        }
+    }
+
+    if (trace_path)
+    {
+        if (!sim_trace_open(trace_path))
+        {
+            perror(trace_path);
+            return (2);
+        }
+        sim_trace_name_pin(X_STEP_PIN, "X_STEP");
+        sim_trace_name_pin(Y_STEP_PIN, "Y_STEP");
+        sim_trace_name_pin(X_DIRECTION_PIN, "X_DIR");
+        sim_trace_name_pin(Y_DIRECTION_PIN, "Y_DIR");
+#ifdef STEPPERS_DISABLE_PIN
+        sim_trace_name_pin(STEPPERS_DISABLE_PIN, "STEPPERS_DISABLE");
+#endif
+    }
+
+    sim_main_thread();
+    sim_clock_start(speed);
+    setup();
+    sim_serial_start(STDIN_FILENO);
+    std::thread(sim_monitor_thread).detach();
+    while (true)
+    {
+        loop();
+    }
+    return (0);
+}
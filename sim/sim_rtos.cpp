@@ -0,0 +1,187 @@
+/*
+    sim_rtos.cpp - FreeRTOS tasks, notifications, mutexes, semaphores and critical sections on host threads
+    Part of the Grbl_Esp32 host simulation, see sim_hal.h
+*/
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "sim_hal.h"
+
+struct sim_task
+{
+    TaskFunction_t function;
+    void *parameters;
+    std::atomic<uint32_t> notify_count;
+};
+
+struct sim_mutex
+{
+    std::recursive_timed_mutex mutex;
+    std::atomic<std::thread::id> owner; // Tells an outermost take from a nested one.
+    uint32_t depth;                     // Written only by the owner.
+    std::atomic<bool> given;            // Binary semaphores only.
+};
+
+static thread_local sim_task *current_task = NULL;
+
+static void task_thread(sim_task *task)
+{
+    current_task = task;
+    task->function(task->parameters);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack_depth,
+                                   void *parameters, UBaseType_t priority, TaskHandle_t *created_task,
+                                   BaseType_t core_id)
+{
+    sim_task *handle = new sim_task();
+    handle->function = task;
+    handle->parameters = parameters;
+    handle->notify_count = 0;
+    if (created_task)
+    {
+        *created_task = handle; // Set before the task runs, like the scheduler does for higher priority tasks.
+    }
+    sim_task_created();
+    std::thread(task_thread, handle).detach();
+    return (pdPASS);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    sim_sleep_us((uint64_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait)
+{
+    sim_task *task = current_task;
+    if (!task)
+    {
+        return (0);
+    }
+    sim_wait([task] { return (task->notify_count != 0); },
+             (ticks_to_wait == portMAX_DELAY) ? SIM_WAIT_FOREVER : ((uint64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000));
+    // Only the task itself takes from the count, so it can not drop between the load and the update.
+    uint32_t count = task->notify_count;
+    if (clear_count_on_exit)
+    {
+        task->notify_count -= count;
+    }
+    else if (count)
+    {
+        task->notify_count--;
+    }
+    return (count);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    task->notify_count++;
+    sim_wake();
+    return (pdPASS);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    xTaskNotifyGive(task);
+    if (higher_priority_task_woken)
+    {
+        *higher_priority_task_woken = pdFALSE;
+    }
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex()
+{
+    return (new sim_mutex());
+}
+
+// The main loop takes the segment prep mutex on every pass of its wait loops, which makes an outermost
+// take a yield point. A waiting thread counts as runnable, since the owner is.
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticks_to_wait)
+{
+    bool nested = (mutex->owner == std::this_thread::get_id());
+    if (!nested)
+    {
+        sim_main_yield_point();
+    }
+    if (ticks_to_wait == portMAX_DELAY)
+    {
+        mutex->mutex.lock();
+    }
+    else
+    {
+        auto timeout = std::chrono::microseconds((uint64_t)(ticks_to_wait * portTICK_PERIOD_MS * 1000 / sim_clock_speed()));
+        if (!mutex->mutex.try_lock_for(timeout))
+        {
+            return (pdFALSE);
+        }
+    }
+    mutex->owner = std::this_thread::get_id();
+    mutex->depth++;
+    return (pdTRUE);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex)
+{
+    if (--mutex->depth == 0)
+    {
+        mutex->owner = std::thread::id();
+    }
+    mutex->mutex.unlock();
+    return (pdTRUE);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    sim_mutex *semaphore = new sim_mutex();
+    semaphore->given = false; // Created empty, like FreeRTOS does.
+    return (semaphore);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    while (true)
+    {
+        bool given = true;
+        if (semaphore->given.compare_exchange_strong(given, false))
+        {
+            return (pdTRUE);
+        }
+        // Another taker may win the semaphore between the wake up and the exchange. Then wait again.
+        if (!sim_wait([semaphore] { return (semaphore->given.load()); },
+                      (ticks_to_wait == portMAX_DELAY) ? SIM_WAIT_FOREVER : ((uint64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000)))
+        {
+            return (pdFALSE);
+        }
+    }
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    semaphore->given = true;
+    sim_wake();
+    return (pdTRUE);
+}
+
+// Critical sections mask the simulated interrupts. The mux itself is not needed, since the
+// interrupt lock already excludes every other thread.
+void vTaskEnterCritical(portMUX_TYPE *mux)
+{
+    sim_interrupt_lock();
+}
+
+void vTaskExitCritical(portMUX_TYPE *mux)
+{
+    sim_interrupt_unlock();
+}
+
+BaseType_t xPortGetCoreID()
+{
+    return (current_task ? 0 : 1); // Tasks run on core 0, loop() on core 1, like the Arduino core.
+}